@@ -35,9 +35,20 @@ void     c4_id_free(c4_id_t *id);
 // Identify data: compute C4 ID from a buffer
 c4_error_t c4_identify(const void *data, size_t len, c4_id_t *out);
 
-// Identify file: compute C4 ID from a file descriptor
+// Identify many buffers at once: out[i] receives the ID of data[i][0..lens[i]).
+// Each out[i] must be an allocated c4_id_t. Small buffers are hashed in
+// parallel SIMD lanes; results match c4_identify.
+c4_error_t c4_identify_many(const void *const *data, const size_t *lens,
+                            size_t count, c4_id_t **out);
+
+// Identify file: compute C4 ID from a file descriptor, reading from its
+// current offset to EOF. Memory use is bounded regardless of input size.
 c4_error_t c4_identify_fd(int fd, c4_id_t *out);
 
+// As c4_identify_fd, with the expected number of remaining bytes
+// (0 = unknown) passed to the kernel as a read-ahead hint.
+c4_error_t c4_identify_fd_hint(int fd, uint64_t size_hint, c4_id_t *out);
+
 // Identify file by path (c4m-aware: .c4m extension triggers canonical heuristic)
 c4_error_t c4_identify_file(const char *path, c4_id_t *out);
 
@@ -66,6 +77,16 @@ const uint8_t *c4_id_digest(const c4_id_t *id);
 // Set ID from raw digest bytes (64 bytes)
 c4_error_t c4_id_from_digest(const void *digest, size_t len, c4_id_t *out);
 
+// Incremental hasher (opaque). Feed data with c4_hasher_update, then
+// c4_hasher_final writes the ID and resets the hasher for reuse.
+typedef struct c4_hasher c4_hasher_t;
+
+c4_hasher_t *c4_hasher_new(void);
+void         c4_hasher_free(c4_hasher_t *h);
+c4_error_t   c4_hasher_update(c4_hasher_t *h, const void *data, size_t len);
+c4_error_t   c4_hasher_final(c4_hasher_t *h, c4_id_t *out);
+c4_error_t   c4_hasher_reset(c4_hasher_t *h);
+
 // Tree operations: compute the C4 ID of a sorted set of IDs.
 // IDs are sorted internally. The result is the ID of the concatenated digests.
 c4_error_t c4_tree_id(const c4_id_t **ids, size_t count, c4_id_t *out);
@@ -9,8 +9,14 @@
 #include <cstdint>
 #include <filesystem>
 #include <iosfwd>
+#include <map>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace c4 {
@@ -18,18 +24,66 @@ namespace c4 {
 constexpr size_t DigestLen = 64;  // SHA-512 digest
 constexpr size_t IDLen = 90;      // Encoded string length
 
+// How IdentifyFile reads file contents.
+enum class IOStrategy {
+    Auto,    // Pick by file size (see IdentifyOptions)
+    Stream,  // std::ifstream with a 256 KiB buffer (portable)
+    Mmap,    // mmap with MADV_SEQUENTIAL
+    Pread,   // Large aligned pread chunks, double-buffered on a reader thread
+    Direct,  // As Pread, but with O_DIRECT (F_NOCACHE on macOS) so the
+             // page cache is left untouched
+};
+
+struct IdentifyOptions {
+    // Auto uses a single pread for small files, mmap up to 1 GiB and
+    // double-buffered pread beyond. Direct is never chosen automatically.
+    // Platforms without POSIX file I/O always use Stream.
+    IOStrategy io = IOStrategy::Auto;
+
+    // Worker threads for IdentifyFiles (0 = hardware concurrency).
+    unsigned threads = 0;
+};
+
+// Result of ID::TryParse.
+enum class ParseStatus {
+    Ok,
+    BadLength,  // not exactly IDLen characters
+    BadPrefix,  // does not start with "c4"
+    BadDigit,   // character outside the base58 alphabet
+    Overflow,   // digits encode a value larger than any SHA-512 digest
+};
+
 // A C4 ID: a 64-byte SHA-512 digest with base58 encoding.
 class ID {
 public:
-    ID();
+    constexpr ID() : digest_{} {}
+
+    // Wrap an existing digest. constexpr, so IDs known at build time
+    // (see the _c4id literal below) cost nothing at run time.
+    constexpr explicit ID(const std::array<uint8_t, DigestLen> &digest) : digest_(digest) {}
 
     // Identify data
     static ID Identify(const void *data, size_t len);
     static ID Identify(std::string_view data);
     static ID Identify(std::istream &stream);
 
+    // Identify count independent buffers; out[i] receives the ID of
+    // inputs[i]. Results are identical to calling Identify on each input,
+    // but small inputs are hashed several at a time in SIMD lanes
+    // (AVX-512 or AVX2 when the CPU has them).
+    static void IdentifyBatch(const std::string_view *inputs, size_t count, ID *out);
+    static std::vector<ID> IdentifyBatch(const std::vector<std::string_view> &inputs);
+
     // Identify a file (c4m-aware: .c4m extension triggers canonical heuristic)
     static ID IdentifyFile(const std::filesystem::path &path);
+    static ID IdentifyFile(const std::filesystem::path &path,
+                           const IdentifyOptions &options);
+
+    // Identify everything readable from an open file descriptor, from its
+    // current offset to EOF. Memory use is bounded regardless of input size.
+    // size_hint (0 = unknown) is the expected number of bytes remaining,
+    // used as a read-ahead hint; regular files are sized with fstat.
+    static ID IdentifyFd(int fd, uint64_t size_hint = 0);
 
     // c4m-aware identification: if data parses as a valid c4m file,
     // canonicalize it before hashing. Otherwise hash raw bytes.
@@ -39,18 +93,32 @@ public:
     // Parse from string
     static ID Parse(std::string_view str);
 
+    // Parse without throwing: on Ok, out holds the ID; otherwise out is
+    // unchanged and the status says why str is not a C4 ID. For scanning
+    // text where most candidates are invalid.
+    static ParseStatus TryParse(std::string_view str, ID &out) noexcept;
+
     // Construct from raw digest bytes (must be exactly DigestLen bytes)
     static ID FromDigest(const uint8_t *data, size_t len);
 
     // Encode to 90-character string
     std::string String() const;
 
+    // Write the same 90 characters to out, without a terminator or any
+    // allocation.
+    void EncodeTo(char out[IDLen]) const;
+
     // Sum computes the combined ID of two IDs by hashing them in sorted
     // order (smaller digest first). If both IDs are equal, returns a copy.
     ID Sum(const ID &other) const;
 
+    // out[i] = left[i].Sum(right[i]) for i < n, with independent pairs
+    // hashed several at a time in SIMD lanes. out may be the same array as
+    // left or right.
+    static void SumPairs(const ID *left, const ID *right, ID *out, size_t n);
+
     // Raw digest access
-    const std::array<uint8_t, DigestLen> &Digest() const;
+    constexpr const std::array<uint8_t, DigestLen> &Digest() const { return digest_; }
 
     // Comparison
     bool operator==(const ID &other) const;
@@ -61,22 +129,214 @@ public:
     bool IsNil() const;
 
 private:
+    friend class IDs;
+    friend void EncodeIDs(const ID *ids, size_t count, char *out);
+    friend void ParseIDs(const char *str, size_t count, ID *out);
+    friend class TreeBuilder;
+    friend class IncrementalIDs;
+
+    // One merkle level: out[i] = in[2i].Sum(in[2i+1]), with an odd last
+    // element passed through to out[count / 2]. out must not overlap in.
+    static void SumAdjacent(const ID *in, size_t count, ID *out);
+
     std::array<uint8_t, DigestLen> digest_;
 };
 
 // Stream output
 std::ostream &operator<<(std::ostream &os, const ID &id);
 
-// A sorted set of IDs that can produce a tree ID.
+// True if str is a well-formed C4 ID (what ID::TryParse would accept),
+// checked without decoding.
+bool IsValidIDString(std::string_view str) noexcept;
+
+// Encode count IDs into out as count * IDLen characters back to back, with
+// no separators or terminators. Same characters as EncodeTo on each ID;
+// several IDs are converted at a time.
+void EncodeIDs(const ID *ids, size_t count, char *out);
+
+// Parse count IDs stored back to back as count * IDLen characters. Same
+// results and errors as ID::Parse on each ID; the base58 alphabet is
+// validated with SIMD table lookups and several IDs are decoded at a time
+// in AVX2 lanes when the CPU has them.
+void ParseIDs(const char *str, size_t count, ID *out);
+
+namespace detail {
+
+// ASCII value -> base58 digit (255 = not in the alphabet).
+inline constexpr std::array<uint8_t, 128> Base58Reverse = [] {
+    constexpr char alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    std::array<uint8_t, 128> table{};
+    for (auto &v : table) v = 255;
+    for (int i = 0; i < 58; i++) {
+        table[static_cast<unsigned char>(alphabet[i])] = static_cast<uint8_t>(i);
+    }
+    return table;
+}();
+
+// Decode a C4 ID string to its digest. Usable in constant expressions,
+// where an invalid string is a compile error; ID::Parse is the fast path
+// for run-time input.
+constexpr std::array<uint8_t, DigestLen> DecodeID(std::string_view str) {
+    if (str.size() != IDLen) {
+        throw std::invalid_argument("invalid C4 ID length");
+    }
+    if (str[0] != 'c' || str[1] != '4') {
+        throw std::invalid_argument("C4 ID must start with 'c4'");
+    }
+    // value = value * 58 + digit over 16 big-endian 32-bit words.
+    uint32_t words[DigestLen / 4] = {};
+    for (size_t i = 2; i < IDLen; i++) {
+        auto c = static_cast<unsigned char>(str[i]);
+        uint64_t carry = c < 128 ? Base58Reverse[c] : 255;
+        if (carry == 255) {
+            throw std::invalid_argument("invalid base58 in C4 ID");
+        }
+        for (size_t w = DigestLen / 4; w-- > 0;) {
+            uint64_t t = uint64_t{words[w]} * 58 + carry;
+            words[w] = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        if (carry != 0) {
+            throw std::invalid_argument("invalid base58 in C4 ID");
+        }
+    }
+    std::array<uint8_t, DigestLen> digest{};
+    for (size_t i = 0; i < DigestLen; i++) {
+        digest[i] = static_cast<uint8_t>(words[i / 4] >> (24 - 8 * (i % 4)));
+    }
+    return digest;
+}
+
+} // namespace detail
+
+namespace literals {
+
+// "c4..."_c4id: an ID decoded from its string form. In a constexpr
+// declaration the string is validated and decoded by the compiler:
+//
+//   using namespace c4::literals;
+//   constexpr c4::ID kEmpty = "c459dsjf...1sFT"_c4id;
+constexpr ID operator""_c4id(const char *str, size_t len) {
+    return ID(detail::DecodeID(std::string_view(str, len)));
+}
+
+} // namespace literals
+
+// Identify many files concurrently on a worker pool; ids[i] is the ID of
+// paths[i], exactly as ID::IdentifyFile would compute it. If any file
+// fails, the remaining work is abandoned and the error is rethrown.
+std::vector<ID> IdentifyFiles(const std::vector<std::filesystem::path> &paths,
+                              const IdentifyOptions &options = {});
+
+// Incremental SHA-512 hasher for data that arrives in pieces (sockets,
+// decompressors, custom readers). Feeding the pieces of a buffer through
+// Update produces the same ID as ID::Identify on the whole buffer.
+// Finalize leaves the hasher reset, ready for the next input.
+class Hasher {
+public:
+    Hasher();
+    ~Hasher();
+
+    Hasher(Hasher &&other) noexcept;
+    Hasher &operator=(Hasher &&other) noexcept;
+    Hasher(const Hasher &) = delete;
+    Hasher &operator=(const Hasher &) = delete;
+
+    void Update(const void *data, size_t len);
+    void Update(std::string_view data);
+
+    // Return the ID of everything passed to Update since the last reset.
+    ID Finalize();
+
+    // Discard any data passed to Update since the last reset.
+    void Reset();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// Proof that an ID is one of the leaves of a tree ID: the sibling nodes on
+// the path from the leaf to the root. Levels where the path node is the odd
+// last element (passed through unpaired) contribute no sibling; index and
+// count determine which levels those are.
+struct InclusionProof {
+    uint64_t index = 0;          // position among the sorted, distinct IDs
+    uint64_t count = 0;          // number of distinct IDs in the tree
+    std::vector<ID> siblings;    // bottom-up
+};
+
+// Check a proof with one Sum per sibling (about log2(count) in total).
+bool VerifyInclusion(const ID &id, const InclusionProof &proof, const ID &tree_id);
+
+namespace detail {
+
+// Allocator for cache-line (64-byte) aligned arrays.
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+    static constexpr std::align_val_t Alignment{64};
+
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U> &) noexcept {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(::operator new(n * sizeof(T), Alignment));
+    }
+    void deallocate(T *p, size_t) noexcept {
+        ::operator delete(p, Alignment);
+    }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U> &) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U> &) const noexcept { return false; }
+};
+
+} // namespace detail
+
+// An array of ID is read and written as packed digests (IDs storage,
+// IDList files), so ID must be exactly its digest.
+static_assert(sizeof(ID) == DigestLen && std::is_trivially_copyable_v<ID>,
+              "c4::ID must be a bare 64-byte digest");
+
+// A set of IDs that can produce a tree ID. The IDs are stored in one
+// contiguous, cache-line aligned array, so each ID fills exactly one line.
 class IDs {
 public:
+    using Storage = std::vector<class ID, detail::CacheAlignedAllocator<class ID>>;
+
     IDs() = default;
 
     void Append(const class ID &id);
     void Append(class ID &&id);
 
-    // Compute the C4 ID of this set (sorts, concatenates digests, hashes)
-    class ID TreeID() const;
+    void Reserve(size_t n);
+
+    // Sort and remove duplicates in place.
+    void SortUnique();
+
+    // True if the IDs are known to be ascending without repeats: after
+    // SortUnique(), or when each Append was larger than the one before.
+    bool SortedUnique() const { return sorted_; }
+
+    // Compute the C4 ID of this set (sorts, concatenates digests, hashes).
+    // A SortedUnique() set is hashed in place; otherwise a sorted copy is
+    // made first.
+    class ID TreeID() const &;
+
+    // As above, but sorts in place and reuses the storage for the upper
+    // tree levels instead of copying. Leaves the set empty.
+    class ID TreeID() &&;
+
+    // TreeID computed on up to `threads` threads (0 = hardware concurrency).
+    // The result is identical to TreeID(); small sets are computed serially.
+    class ID ParallelTreeID(unsigned threads = 0) const;
+
+    // Inclusion proof for id against TreeID(). Hashes the whole set once;
+    // throws std::invalid_argument if id is not in the set.
+    InclusionProof Proof(const class ID &id) const;
 
     size_t Size() const;
     bool Empty() const;
@@ -88,7 +348,88 @@ public:
     auto end() const { return ids_.end(); }
 
 private:
-    std::vector<c4::ID> ids_;
+    // Tree ID of n sorted, distinct leaves. spare is scratch for the upper
+    // levels and may be the storage holding the leaves.
+    static class ID reduce(const class ID *leaves, size_t n, Storage &spare, unsigned workers);
+
+    Storage ids_;
+    bool sorted_ = true;
+};
+
+// Streaming tree ID over IDs that arrive already sorted, e.g. read from a
+// sorted file on disk. The result equals IDs::TreeID over the same IDs,
+// while memory stays bounded: a small leaf batch plus one pending node per
+// tree level.
+class TreeBuilder {
+public:
+    TreeBuilder() = default;
+
+    // Add the next ID. IDs must be in ascending order; an ID equal to the
+    // previous one is skipped, a smaller one throws std::invalid_argument.
+    void Add(const class ID &id);
+
+    // Tree ID of everything added since the last reset (nil if nothing).
+    // Leaves the builder reset, ready for the next set.
+    class ID Finalize();
+
+    void Reset();
+
+    // Number of distinct IDs added since the last reset.
+    uint64_t Count() const { return count_; }
+
+private:
+    void push(size_t level, const class ID &node);
+    void flushLeaves();
+
+    std::vector<c4::ID> leaves_;                // leaves not yet hashed, in batches
+    std::vector<std::optional<c4::ID>> levels_; // unpaired node at each level
+    c4::ID last_;
+    uint64_t count_ = 0;
+};
+
+// A sorted ID set that keeps every intermediate merkle level, so its tree
+// ID can be refreshed after small changes without a full rebuild. Inserts
+// and removals are queued and applied by the next TreeID, Size or Proof
+// call; Contains sees queued changes without applying them. Only pairs
+// whose inputs changed or moved to a different pairing are rehashed; runs
+// of untouched IDs whose position shifted by an even amount reuse their
+// cached sums.
+//
+// Not safe for concurrent use, including concurrent const calls.
+class IncrementalIDs {
+public:
+    IncrementalIDs() = default;
+    explicit IncrementalIDs(const IDs &ids);
+
+    // Queue a change. For the same ID, the last queued change wins;
+    // inserting a present ID or removing an absent one does nothing.
+    void Insert(const class ID &id);
+    void Remove(const class ID &id);
+
+    // Equal to IDs::TreeID over the current set (nil if empty).
+    class ID TreeID() const;
+
+    size_t Size() const;
+    bool Contains(const class ID &id) const;
+
+    // Inclusion proof for id against TreeID(), read from the cached levels
+    // without hashing. Throws std::invalid_argument if id is not in the set.
+    InclusionProof Proof(const class ID &id) const;
+
+private:
+    // Index range [begin, end) of a level whose nodes are unchanged from
+    // the previous version of that level, starting at old index old_begin.
+    struct Run {
+        size_t begin;
+        size_t end;
+        size_t old_begin;
+    };
+
+    void apply() const;
+    void rebuild(std::vector<c4::ID> leaves, std::vector<Run> runs) const;
+
+    mutable std::vector<std::vector<c4::ID>> levels_;  // levels_[0]: sorted IDs
+    mutable std::map<c4::ID, bool> pending_;           // ID -> insert (true) / remove
 };
 
 } // namespace c4
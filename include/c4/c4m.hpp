@@ -99,11 +99,16 @@ class Manifest {
 public:
     Manifest() = default;
 
-    // Parse from string
-    static Manifest Parse(std::string_view data);
+    // Parse from string. Lines are read in place, without copying data.
+    // With threads other than 1 (0 = hardware concurrency), inputs of a few
+    // MiB or more are split at line boundaries and the chunks tokenized in
+    // parallel. The result, and any error and its line number, is the same
+    // as with one thread.
+    static Manifest Parse(std::string_view data, unsigned threads = 1);
 
-    // Parse from file
-    static Manifest ParseFile(const std::filesystem::path &path);
+    // Parse from file. Regular files are memory-mapped and parsed like a
+    // string (in parallel as above); anything else is read as a stream.
+    static Manifest ParseFile(const std::filesystem::path &path, unsigned threads = 1);
 
     // Parse from stream
     static Manifest Parse(std::istream &stream);
@@ -129,6 +134,10 @@ public:
     // Flat list of all entry pointers
     std::vector<const Entry *> AllEntries() const;
 
+    // IDs of every entry that has one (nil IDs skipped), in entry order
+    // and possibly repeated, e.g. to build an IDFilter of the content.
+    c4::IDs EntryIDs() const;
+
     // Lookup by full path (e.g., "src/main.go") via tree index (O(1)).
     const Entry *GetEntry(const std::string &path) const;
 
@@ -207,6 +216,65 @@ private:
     void invalidateIndex();
 };
 
+// Pull-style reader yielding the entries of a .c4m manifest one at a
+// time, for manifests too large to hold as a Manifest. Memory use is
+// bounded by the longest line and the deepest path, not the entry count.
+// Lines are tokenized exactly as by Manifest::Parse, and errors are the
+// same. Entries come out as written: the sections of a patch chain follow
+// one another unresolved, and checkpoints are not verified.
+//
+//     c4m::ManifestReader reader(path);
+//     c4m::Entry e;
+//     while (reader.Next(e))
+//         total += e.size;
+class ManifestReader {
+public:
+    // Read from a buffer, which must outlive the reader.
+    explicit ManifestReader(std::string_view data);
+
+    // Read from a stream, which must outlive the reader.
+    explicit ManifestReader(std::istream &stream);
+
+    // Read from a file: memory-mapped if it is a regular file, otherwise
+    // read as a stream. Throws std::runtime_error if it cannot be opened.
+    explicit ManifestReader(const std::filesystem::path &path);
+
+    ~ManifestReader();
+    ManifestReader(ManifestReader &&other) noexcept;
+    ManifestReader &operator=(ManifestReader &&other) noexcept;
+    ManifestReader(const ManifestReader &) = delete;
+    ManifestReader &operator=(const ManifestReader &) = delete;
+
+    // Read the next entry into entry, overwriting every field and reusing
+    // its strings' storage, so a loop over one Entry does not allocate
+    // once the strings have grown. depth is set. Returns false at the end
+    // of input; throws std::runtime_error on a malformed line.
+    bool Next(Entry &entry);
+
+    // Full path of the entry last returned by Next (e.g. "src/main.go"),
+    // as Manifest::EntryPath gives it.
+    const std::string &Path() const;
+
+    // Line number of the entry last returned by Next.
+    int LineNumber() const;
+
+    // External base reference (a bare C4 ID on the first line), or nil.
+    // Known once Next has been called.
+    const c4::ID &Base() const;
+
+    // Call fn(entry, path) for each remaining entry, through one reused Entry.
+    template <typename Fn>
+    void ForEach(Fn &&fn) {
+        Entry entry;
+        while (Next(entry))
+            fn(static_cast<const Entry &>(entry), Path());
+    }
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
 // -----------------------------------------------------------------------
 // Operation result types
 // -----------------------------------------------------------------------
@@ -292,11 +360,11 @@ bool NaturalLess(const std::string &a, const std::string &b);
 
 // Mode string conversion
 std::string FormatMode(uint32_t mode);
-uint32_t ParseMode(const std::string &s);
+uint32_t ParseMode(std::string_view s);
 
 // Timestamp conversion (RFC3339 UTC)
 std::string FormatTimestamp(int64_t unix_seconds);
-int64_t ParseTimestamp(const std::string &s);
+int64_t ParseTimestamp(std::string_view s);
 
 // SafeName encoding (Universal Filename Encoding, three-tier system).
 // Tier 1: printable UTF-8 passthrough (except currency sign U+00A4 and backslash)
@@ -305,7 +373,7 @@ int64_t ParseTimestamp(const std::string &s);
 std::string SafeName(const std::string &raw);
 
 // UnsafeName reverses SafeName encoding.
-std::string UnsafeName(const std::string &encoded);
+std::string UnsafeName(std::string_view encoded);
 
 // EscapeField applies c4m field-boundary escaping on top of SafeName:
 // space -> "\ ", double-quote -> "\"", and for non-sequences, [ -> "\[", ] -> "\]".
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+// Binary on-disk format for sorted ID sets.
+//
+// Layout (integers little-endian), in the style of a git pack index:
+//
+//   0     8   magic "C4IDLIST"
+//   8     4   version (1)
+//   12    4   flags (bit 0: fanout table present)
+//   16    8   count of IDs
+//   24   40   reserved, zero
+//   64 2048   fanout (optional): entry b = number of IDs whose first
+//             digest byte is <= b
+//   ...       count packed 64-byte digests, ascending and distinct
+//
+// The digests start on a 64-byte boundary, so a mapped file is read with
+// one ID per cache line, and nothing is parsed when it is opened.
+
+#ifndef C4_IDLIST_HPP
+#define C4_IDLIST_HPP
+
+#include "c4/c4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace c4 {
+
+// A read-only sorted ID set backed by a memory-mapped IDList file.
+class IDList {
+public:
+    // Write ids (sorted and deduplicated on the way if needed) to path.
+    static void Write(const std::filesystem::path &path, const IDs &ids, bool fanout = true);
+
+    // Map the file at path. The header and fanout table are checked; the
+    // digests are not read until used. Throws std::runtime_error on I/O
+    // errors or a malformed file. Platforms without mmap read the file
+    // into memory instead.
+    static IDList Open(const std::filesystem::path &path);
+
+    IDList() = default;
+    ~IDList();
+    IDList(IDList &&other) noexcept;
+    IDList &operator=(IDList &&other) noexcept;
+    IDList(const IDList &) = delete;
+    IDList &operator=(const IDList &) = delete;
+
+    size_t Size() const { return count_; }
+    bool Empty() const { return count_ == 0; }
+
+    // The i-th ID in ascending order.
+    ID operator[](size_t i) const;
+
+    // Binary search, narrowed by the fanout table when present.
+    bool Contains(const ID &id) const;
+
+    // Tree ID of the set, streamed from the mapping through a TreeBuilder
+    // so memory use stays bounded however large the file is. Throws
+    // std::runtime_error if the digests are not strictly ascending.
+    ID TreeID() const;
+
+    // The packed digests: Size() * DigestLen bytes.
+    const uint8_t *Digests() const { return digests_; }
+
+private:
+    void release();
+
+    const uint8_t *digests_ = nullptr;
+    size_t count_ = 0;
+    const uint8_t *fanout_ = nullptr;  // 256 little-endian uint64, or null
+
+    void *map_ = nullptr;             // mmap base, if mapped
+    size_t map_len_ = 0;
+    std::vector<uint8_t> buffer_;     // file contents, if not mapped
+};
+
+} // namespace c4
+
+#endif // C4_IDLIST_HPP
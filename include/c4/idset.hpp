@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: Apache-2.0
+// Hash containers keyed by C4 ID.
+//
+// std::unordered_set<c4::ID> allocates a node per element holding the
+// 64-byte key and chases a pointer on every probe. IDSet and IDMap keep
+// the keys (and values) in dense arrays and index them with an
+// open-addressing probe array of 8-byte slots: a 32-bit tag and a 32-bit
+// position. Digests are uniformly distributed, so the digest bits are the
+// hash: the slot index and the tag are read straight from the first 8
+// bytes. A probe touches only the slot array until a tag matches, and the
+// full digest is compared only then.
+
+#ifndef C4_IDSET_HPP
+#define C4_IDSET_HPP
+
+#include "c4/c4.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace c4 {
+
+template <typename V> class IDMap;
+
+// Set of IDs. Iteration visits the IDs in insertion order, except that
+// Remove moves the last ID into the removed one's place.
+class IDSet {
+public:
+    IDSet() = default;
+
+    // Insert id; returns false if it was already present.
+    bool Insert(const ID &id);
+
+    bool Contains(const ID &id) const;
+
+    // Remove id; returns false if it was not present.
+    bool Remove(const ID &id);
+
+    // Make room for n IDs without rehashing.
+    void Reserve(size_t n);
+
+    void Clear();
+    size_t Size() const { return keys_.size(); }
+    bool Empty() const { return keys_.empty(); }
+
+    const ID *begin() const { return keys_.data(); }
+    const ID *end() const { return keys_.data() + keys_.size(); }
+
+private:
+    template <typename V> friend class IDMap;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    struct Slot {
+        uint32_t tag;
+        uint32_t pos;  // index into keys_ + 1; 0 = empty
+    };
+
+    // Position of id in keys_, or npos.
+    size_t find(const ID &id) const;
+
+    // Position of id in keys_, appending it first if absent.
+    std::pair<size_t, bool> insert(const ID &id);
+
+    // Remove id, moving the last key into its position. Returns the
+    // position it had, or npos. Does not throw, so IDMap can use it to
+    // undo an insert whose value failed to construct.
+    size_t remove(const ID &id);
+
+    void rehash(size_t slots);
+
+    std::vector<ID> keys_;
+    std::vector<Slot> slots_;
+};
+
+// Map from ID to V, laid out like IDSet with the values in a second dense
+// array parallel to the keys.
+template <typename V>
+class IDMap {
+public:
+    IDMap() = default;
+
+    // Insert (id, value) unless id is present; returns the stored value and
+    // whether it was inserted.
+    std::pair<V *, bool> Insert(const ID &id, V value) {
+        auto [pos, inserted] = index_.insert(id);
+        if (inserted) {
+            try {
+                values_.push_back(std::move(value));
+            } catch (...) {
+                index_.remove(id);
+                throw;
+            }
+        }
+        return {&values_[pos], inserted};
+    }
+
+    // Value for id, default-constructed on first use.
+    V &operator[](const ID &id) {
+        auto [pos, inserted] = index_.insert(id);
+        if (inserted) {
+            try {
+                values_.emplace_back();
+            } catch (...) {
+                index_.remove(id);
+                throw;
+            }
+        }
+        return values_[pos];
+    }
+
+    // Value for id, or nullptr if absent.
+    V *Find(const ID &id) {
+        size_t pos = index_.find(id);
+        return pos == IDSet::npos ? nullptr : &values_[pos];
+    }
+    const V *Find(const ID &id) const {
+        size_t pos = index_.find(id);
+        return pos == IDSet::npos ? nullptr : &values_[pos];
+    }
+
+    bool Contains(const ID &id) const { return index_.Contains(id); }
+
+    // Remove id; returns false if it was not present.
+    bool Remove(const ID &id) {
+        size_t pos = index_.remove(id);
+        if (pos == IDSet::npos) {
+            return false;
+        }
+        if (pos + 1 != values_.size()) {
+            values_[pos] = std::move(values_.back());
+        }
+        values_.pop_back();
+        return true;
+    }
+
+    void Reserve(size_t n) {
+        index_.Reserve(n);
+        values_.reserve(n);
+    }
+
+    void Clear() {
+        index_.Clear();
+        values_.clear();
+    }
+
+    size_t Size() const { return index_.Size(); }
+    bool Empty() const { return index_.Empty(); }
+
+    // The i-th ID of Keys() maps to Values()[i].
+    const IDSet &Keys() const { return index_; }
+    const std::vector<V> &Values() const { return values_; }
+
+private:
+    IDSet index_;
+    std::vector<V> values_;
+};
+
+} // namespace c4
+
+#endif // C4_IDSET_HPP
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: Apache-2.0
+// Resolve abbreviated C4 IDs ("c4abc12") against a set of IDs.
+//
+// C4 ID strings are fixed width and the base58 alphabet is in ascending
+// ASCII order, so string order is digest order. The IDs starting with a
+// prefix are therefore one contiguous range of the sorted digests, bounded
+// by the prefix padded with the lowest digit ('1') and with the highest
+// ('z'). Decoding the two bounds and two binary searches resolve a prefix
+// without encoding any ID.
+
+#ifndef C4_PREFIXINDEX_HPP
+#define C4_PREFIXINDEX_HPP
+
+#include "c4/c4.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace c4 {
+
+enum class PrefixMatch {
+    Unique,     // exactly one ID starts with the prefix
+    None,       // no ID does
+    Ambiguous,  // more than one does
+    Invalid,    // not "c4" followed by up to 88 base58 digits
+};
+
+struct PrefixResult {
+    PrefixMatch match = PrefixMatch::None;
+    ID id;             // the match when Unique, else the first match (if any)
+    size_t count = 0;  // number of IDs starting with the prefix
+};
+
+class PrefixIndex {
+public:
+    PrefixIndex() = default;
+
+    // Index a set, e.g. Manifest::EntryIDs(). Duplicates are dropped.
+    explicit PrefixIndex(IDs ids);
+
+    // Look up an abbreviated ID in O(log n). A full 90-character ID
+    // resolves to itself if present.
+    PrefixResult Resolve(std::string_view prefix) const;
+
+    size_t Size() const { return ids_.Size(); }
+
+private:
+    IDs ids_;  // sorted and unique
+};
+
+} // namespace c4
+
+#endif // C4_PREFIXINDEX_HPP
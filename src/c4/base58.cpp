@@ -0,0 +1,351 @@
+// SPDX-License-Identifier: Apache-2.0
+// Fixed-width base58 for C4 IDs.
+//
+// Both directions are specialized for the one size C4 uses: a 512-bit
+// digest and exactly 88 digits, so every loop has a fixed trip count and
+// leading zero digits ('1') need no separate padding step.
+//
+// Encoding reads the digest as 16 big-endian 32-bit words and divides it
+// repeatedly by 58^5, which fits a 32-bit limb: each step is a 64-bit
+// division by a constant, compiled to a reciprocal multiply. Decoding runs
+// the other way with multiplications only: the digits are grouped into
+// 58^5 chunks and accumulated by Horner's rule. In both directions the
+// high words are known to be zero for the first steps and are skipped.
+//
+// The batch variants decode 4 IDs per AVX2 register (one 32-bit word per
+// 64-bit lane, so _mm256_mul_epu32 yields the full product) and validate
+// the alphabet with a nibble-table shuffle. Batch encoding interleaves
+// several IDs in scalar registers instead: AVX2 has no 64-bit multiply-high
+// to divide by 58^5, and emulating one costs more than it saves, while the
+// scalar division chain is latency-bound and gains from running 4 IDs side
+// by side.
+
+#include "base58.h"
+
+#include "c4/c4.hpp"
+
+#include <array>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define C4_BASE58_X86 1
+#include <immintrin.h>
+#else
+#define C4_BASE58_X86 0
+#endif
+
+namespace {
+
+using c4::base58::Alphabet;
+using c4::base58::DigestLen;
+using c4::base58::DigitsLen;
+
+constexpr uint32_t D5 = 656356768;  // 58^5
+constexpr int kWords = 16;          // 32-bit words in 512 bits
+constexpr int kChunks = 18;         // ceil(88 / 5); the first holds 3 digits
+
+// Reverse lookup table: ASCII value -> base58 digit (255 = invalid). Shared
+// with the constexpr decoder behind the _c4id literal.
+constexpr const auto &b58Reverse = c4::detail::Base58Reverse;
+
+// Encoding of 2^512 - 1. Digit strings are fixed width and the alphabet is
+// in ascending ASCII order, so a larger string means a larger value.
+constexpr char kMaxDigits[] =
+    "67rpwLCuS5DGA8KGZXKsVQ7dnPb9goRLoKfgGbLfQg9WoLUgNY77E2jT11fem3coV9nAkguBACzrU1iyZM4B8roQ";
+static_assert(sizeof(kMaxDigits) == DigitsLen + 1, "kMaxDigits must be 88 digits");
+
+// Words of the value that can be nonzero after `chunk` chunks have been
+// accumulated (value < 58^(3 + 5 * (chunk - 1)) <= 2^(5.86 * digits)).
+constexpr int decodeWords(int chunk) {
+    int digits = 3 + 5 * (chunk - 1);
+    int bits = digits * 586 / 100 + 1;
+    return bits / 32 + 1 < kWords ? bits / 32 + 1 : kWords;
+}
+
+// Leading words known to be zero after `limb` divisions by 58^5 > 2^29.
+constexpr int encodeZeroWords(int limb) {
+    return limb * 29 / 32;
+}
+
+bool validDigitsScalar(const char *digits) {
+    for (size_t i = 0; i < DigitsLen; i++) {
+        auto c = static_cast<unsigned char>(digits[i]);
+        if (c >= 128 || b58Reverse[c] == 255) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 88 digits -> 18 chunk values, most significant first.
+void chunkValues(const uint8_t *d, uint32_t chunks[kChunks]) {
+    chunks[0] = (d[0] * 58u + d[1]) * 58u + d[2];
+    for (int k = 1; k < kChunks; k++) {
+        const uint8_t *p = d + 3 + 5 * (k - 1);
+        chunks[k] = (((p[0] * 58u + p[1]) * 58u + p[2]) * 58u + p[3]) * 58u + p[4];
+    }
+}
+
+void storeWords(const uint32_t words[kWords], uint8_t *out) {
+    for (int w = 0; w < kWords; w++) {
+        uint32_t v = words[w];
+        uint8_t *p = out + DigestLen - 4 * (w + 1);
+        p[0] = static_cast<uint8_t>(v >> 24);
+        p[1] = static_cast<uint8_t>(v >> 16);
+        p[2] = static_cast<uint8_t>(v >> 8);
+        p[3] = static_cast<uint8_t>(v);
+    }
+}
+
+// Horner's rule over the chunks; words[0] is least significant.
+void decodeChunks(const uint32_t chunks[kChunks], uint8_t *out) {
+    uint32_t words[kWords] = {};
+    words[0] = chunks[0];
+    for (int k = 1; k < kChunks; k++) {
+        uint64_t carry = chunks[k];
+        const int n = decodeWords(k + 1);
+        for (int w = 0; w < n; w++) {
+            uint64_t p = uint64_t(words[w]) * D5 + carry;
+            words[w] = static_cast<uint32_t>(p);
+            carry = p >> 32;
+        }
+    }
+    storeWords(words, out);
+}
+
+void decodeScalar(const char *digits, uint8_t *out) {
+    uint8_t d[DigitsLen];
+    for (size_t i = 0; i < DigitsLen; i++) {
+        d[i] = b58Reverse[static_cast<unsigned char>(digits[i])];
+    }
+    uint32_t chunks[kChunks];
+    chunkValues(d, chunks);
+    decodeChunks(chunks, out);
+}
+
+// Encode N digests side by side. The per-digest division chains are
+// independent, so interleaving them hides the multiply latency.
+template <int N>
+void encodeInterleaved(const uint8_t *const *digests, char *const *out) {
+    uint32_t words[N][kWords];
+    for (int n = 0; n < N; n++) {
+        const uint8_t *p = digests[n];
+        for (int i = 0; i < kWords; i++) {
+            words[n][i] = (uint32_t(p[4 * i]) << 24) | (uint32_t(p[4 * i + 1]) << 16) |
+                          (uint32_t(p[4 * i + 2]) << 8) | uint32_t(p[4 * i + 3]);
+        }
+    }
+
+    // limbs[.][0] is least significant. 58^88 > 2^512, so 18 divisions
+    // leave the quotient zero.
+    uint32_t limbs[N][kChunks];
+    for (int l = 0; l < kChunks; l++) {
+        uint64_t rem[N] = {};
+        for (int i = encodeZeroWords(l); i < kWords; i++) {
+            for (int n = 0; n < N; n++) {
+                uint64_t acc = (rem[n] << 32) | words[n][i];
+                words[n][i] = static_cast<uint32_t>(acc / D5);
+                rem[n] = acc % D5;
+            }
+        }
+        for (int n = 0; n < N; n++) {
+            limbs[n][l] = static_cast<uint32_t>(rem[n]);
+        }
+    }
+
+    // 5 digits per limb, least significant last. The top limb holds only
+    // the leading 3 digits (88 = 17 * 5 + 3).
+    for (int n = 0; n < N; n++) {
+        char *p = out[n] + DigitsLen;
+        for (int l = 0; l < kChunks - 1; l++) {
+            uint32_t v = limbs[n][l];
+            for (int d = 0; d < 5; d++) {
+                *--p = Alphabet[v % 58];
+                v /= 58;
+            }
+        }
+        uint32_t v = limbs[n][kChunks - 1];
+        for (int d = 0; d < 3; d++) {
+            *--p = Alphabet[v % 58];
+            v /= 58;
+        }
+    }
+}
+
+#if C4_BASE58_X86
+
+// Nibble tables for the alphabet check: a byte is a base58 digit iff
+// kLoNibble[lo] & kHiNibble[hi] != 0. Each high nibble 3..7 owns one bit;
+// kLoNibble[lo] collects the bits of the high nibbles h for which
+// (h << 4 | lo) is in the alphabet. High nibbles 0-2 and 8-F map to 0.
+constexpr std::array<uint8_t, 16> kLoNibble = [] {
+    std::array<uint8_t, 16> t{};
+    for (int i = 0; i < 58; i++) {
+        auto c = static_cast<unsigned char>(Alphabet[i]);
+        t[c & 0x0f] |= static_cast<uint8_t>(1 << ((c >> 4) - 3));
+    }
+    return t;
+}();
+constexpr std::array<uint8_t, 16> kHiNibble = {0, 0, 0, 1, 2, 4, 8, 16, 0, 0, 0, 0, 0, 0, 0, 0};
+
+__attribute__((target("avx2")))
+inline __m256i nibbleTable(const std::array<uint8_t, 16> &t) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(t.data()));
+    return _mm256_broadcastsi128_si256(v);
+}
+
+// Nonzero bytes of the result mark valid digits.
+__attribute__((target("avx2")))
+inline __m256i classify(__m256i c, __m256i lo_table, __m256i hi_table) {
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    __m256i lo = _mm256_and_si256(c, mask);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(c, 4), mask);
+    return _mm256_and_si256(_mm256_shuffle_epi8(lo_table, lo), _mm256_shuffle_epi8(hi_table, hi));
+}
+
+// Map valid digit characters to values 0..57: subtract '1', then close
+// the gaps the alphabet skips (':'..'@', 'I', 'O', '['..'`', 'l').
+__attribute__((target("avx2")))
+inline __m256i above(__m256i c, char x) {
+    return _mm256_cmpgt_epi8(c, _mm256_set1_epi8(x));
+}
+
+__attribute__((target("avx2")))
+inline __m256i digitValues(__m256i c) {
+    __m256i v = _mm256_sub_epi8(c, _mm256_set1_epi8('1'));
+    v = _mm256_sub_epi8(v, _mm256_and_si256(above(c, '9'), _mm256_set1_epi8(7)));
+    v = _mm256_add_epi8(v, above(c, 'H'));  // mask bytes are -1
+    v = _mm256_add_epi8(v, above(c, 'N'));
+    v = _mm256_sub_epi8(v, _mm256_and_si256(above(c, 'Z'), _mm256_set1_epi8(6)));
+    v = _mm256_add_epi8(v, above(c, 'k'));
+    return v;
+}
+
+// The 88 digits as three 32-byte loads; the last overlaps the second.
+constexpr size_t kLoadOffsets[3] = {0, 32, DigitsLen - 32};
+
+__attribute__((target("avx2")))
+bool validDigitsAvx2(const char *digits) {
+    __m256i lo_table = nibbleTable(kLoNibble);
+    __m256i hi_table = nibbleTable(kHiNibble);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i bad = zero;
+    for (size_t off : kLoadOffsets) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(digits + off));
+        bad = _mm256_or_si256(bad, _mm256_cmpeq_epi8(classify(c, lo_table, hi_table), zero));
+    }
+    return _mm256_testz_si256(bad, bad);
+}
+
+// Decode 4 validated digit strings; lane l of each vector is ID l.
+__attribute__((target("avx2")))
+void decodeX4(const char *const *digits, uint8_t *const *out) {
+    uint32_t chunks[4][kChunks];
+    for (int l = 0; l < 4; l++) {
+        alignas(32) uint8_t d[96];
+        for (int i = 0; i < 3; i++) {
+            __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(digits[l] + kLoadOffsets[i]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + kLoadOffsets[i]), digitValues(c));
+        }
+        chunkValues(d, chunks[l]);
+    }
+
+    const __m256i d5 = _mm256_set1_epi64x(D5);
+    const __m256i low32 = _mm256_set1_epi64x(0xffffffff);
+    __m256i words[kWords];
+    for (int w = 0; w < kWords; w++)
+        words[w] = _mm256_setzero_si256();
+    words[0] = _mm256_setr_epi64x(chunks[0][0], chunks[1][0], chunks[2][0], chunks[3][0]);
+
+    for (int k = 1; k < kChunks; k++) {
+        __m256i carry = _mm256_setr_epi64x(chunks[0][k], chunks[1][k], chunks[2][k], chunks[3][k]);
+        const int n = decodeWords(k + 1);
+        for (int w = 0; w < n; w++) {
+            __m256i p = _mm256_add_epi64(_mm256_mul_epu32(words[w], d5), carry);
+            words[w] = _mm256_and_si256(p, low32);
+            carry = _mm256_srli_epi64(p, 32);
+        }
+    }
+
+    alignas(32) uint64_t lanes[kWords][4];
+    for (int w = 0; w < kWords; w++)
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes[w]), words[w]);
+    for (int l = 0; l < 4; l++) {
+        uint32_t v[kWords];
+        for (int w = 0; w < kWords; w++)
+            v[w] = static_cast<uint32_t>(lanes[w][l]);
+        storeWords(v, out[l]);
+    }
+}
+
+#endif // C4_BASE58_X86
+
+bool detectAvx2() {
+#if C4_BASE58_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool hasAvx2() {
+    static const bool avx2 = detectAvx2();
+    return avx2;
+}
+
+} // anonymous namespace
+
+namespace c4::base58 {
+
+Check Validate(const char *str, size_t len) {
+    if (len != DigitsLen + 2) {
+        return Check::BadLength;
+    }
+    if (str[0] != 'c' || str[1] != '4') {
+        return Check::BadPrefix;
+    }
+    const char *digits = str + 2;
+#if C4_BASE58_X86
+    bool valid = hasAvx2() ? validDigitsAvx2(digits) : validDigitsScalar(digits);
+#else
+    bool valid = validDigitsScalar(digits);
+#endif
+    if (!valid) {
+        return Check::BadDigit;
+    }
+    if (std::memcmp(digits, kMaxDigits, DigitsLen) > 0) {
+        return Check::Overflow;
+    }
+    return Check::Ok;
+}
+
+void Decode(const char *digits, uint8_t out[DigestLen]) {
+    decodeScalar(digits, out);
+}
+
+void DecodeMany(const char *const *digits, size_t count, uint8_t *const *out) {
+    size_t i = 0;
+#if C4_BASE58_X86
+    if (hasAvx2()) {
+        for (; i + 4 <= count; i += 4)
+            decodeX4(digits + i, out + i);
+    }
+#endif
+    for (; i < count; i++)
+        decodeScalar(digits[i], out[i]);
+}
+
+void Encode(const uint8_t digest[DigestLen], char out[DigitsLen]) {
+    encodeInterleaved<1>(&digest, &out);
+}
+
+void EncodeMany(const uint8_t *const *digests, size_t count, char *const *out) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        encodeInterleaved<4>(digests + i, out + i);
+    for (; i < count; i++)
+        encodeInterleaved<1>(digests + i, out + i);
+}
+
+} // namespace c4::base58
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: Apache-2.0
+// Fixed-width base58 for C4 IDs: a 64-byte digest <-> exactly 88 digits.
+//
+// The single-ID routines are scalar. The *Many variants convert several
+// IDs at once in AVX2 lanes when the CPU has them, and fall back to the
+// scalar routines otherwise.
+#ifndef C4_BASE58_H
+#define C4_BASE58_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace c4::base58 {
+
+constexpr size_t DigitsLen = 88;
+constexpr size_t DigestLen = 64;
+
+constexpr char Alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+// Outcome of validating a 90-character C4 ID string.
+enum class Check {
+    Ok,
+    BadLength,  // not exactly 90 characters
+    BadPrefix,  // does not start with "c4"
+    BadDigit,   // character outside the base58 alphabet
+    Overflow,   // valid digits, but the value does not fit in 512 bits
+};
+
+// Validate a full C4 ID string ("c4" + 88 digits). The alphabet is checked
+// with a SIMD nibble-table lookup when the CPU allows.
+Check Validate(const char *str, size_t len);
+
+// Decode 88 digits that passed Validate.
+void Decode(const char *digits, uint8_t out[DigestLen]);
+
+// Decode count digit strings (each 88 digits that passed Validate).
+void DecodeMany(const char *const *digits, size_t count, uint8_t *const *out);
+
+// Encode a digest as 88 digits, '1'-padded. No terminator.
+void Encode(const uint8_t digest[DigestLen], char out[DigitsLen]);
+
+// Encode count digests; out[i] receives 88 digits.
+void EncodeMany(const uint8_t *const *digests, size_t count, char *const *out);
+
+} // namespace c4::base58
+
+#endif // C4_BASE58_H
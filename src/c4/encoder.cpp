@@ -7,213 +7,121 @@
 // Unlike Bitcoin's base58check, C4 uses fixed-width encoding: always 88
 // base58 chars for 64 bytes. No leading-zero/leading-'1' convention.
 //
-// This implementation uses 64-bit limb arithmetic for performance: instead
-// of processing one base58 digit at a time, we pack up to 9 base58 digits
-// per 64-bit limb (58^9 < 2^63), reducing the inner loop iterations ~9x.
+// The digit arithmetic lives in base58.cpp; this file maps it onto the ID
+// and C APIs.
 
 #include "c4/c4.hpp"
 #include "c4/c4.h"
+#include "base58.h"
 
 #include <algorithm>
 #include <array>
 #include <cstring>
 #include <stdexcept>
 #include <string>
-#ifndef _WIN32
-#include <unistd.h>
-#else
-#include <io.h>
-#endif
+#include <vector>
 
-namespace {
-
-// Bitcoin base58 alphabet
-constexpr char b58Alphabet[] =
-    "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
-
-// Reverse lookup table: ASCII value -> base58 digit (255 = invalid)
-constexpr std::array<uint8_t, 128> b58Reverse = []() {
-    std::array<uint8_t, 128> table{};
-    for (auto &v : table) v = 255;
-    for (int i = 0; i < 58; i++) {
-        table[static_cast<unsigned char>(b58Alphabet[i])] = static_cast<uint8_t>(i);
-    }
-    return table;
-}();
-
-// Digits per limb for encoding (base58 -> bytes direction).
-// 58^9 = 7,427,658,739,644,928. Max intermediate: (58^9-1)*256 + 255 < 2^64. Safe.
-constexpr int kDigitsPerLimb = 9;
-constexpr uint64_t POW58 = 7427658739644928ULL; // 58^9
-
-// For a 64-byte (512-bit) input, we need at most 88 base58 digits.
-// 88 / 9 = 10 limbs (ceil).
-constexpr int kMaxLimbs = 10;
-
-// Encode raw bytes to base58 string using 64-bit limb arithmetic.
-// Each limb holds a value in [0, 58^9), representing 9 base58 digits.
-std::string base58Encode(const uint8_t *data, size_t len) {
-    uint64_t limbs[kMaxLimbs] = {};
-    int nlimbs = 0;
-
-    for (size_t i = 0; i < len; i++) {
-        uint64_t carry = data[i];
-        for (int j = 0; j < nlimbs; j++) {
-            uint64_t acc = limbs[j] * 256 + carry;
-            limbs[j] = acc % POW58;
-            carry = acc / POW58;
-        }
-        while (carry > 0) {
-            limbs[nlimbs++] = carry % POW58;
-            carry /= POW58;
-        }
-    }
+namespace c4 {
 
-    // Extract base58 digits from limbs (most-significant limb first).
-    // Each limb except the most-significant produces exactly kDigitsPerLimb digits.
-    // The most-significant limb produces only as many digits as needed.
-    char result[90];
-    int pos = 0;
+void ID::EncodeTo(char out[IDLen]) const {
+    out[0] = 'c';
+    out[1] = '4';
+    // Always 88 digits, '1'-padded (base58 zero) — matches Go behavior
+    base58::Encode(digest_.data(), out + 2);
+}
 
-    if (nlimbs == 0) {
-        return "";
-    }
+std::string ID::String() const {
+    std::string s(IDLen, '\0');
+    EncodeTo(s.data());
+    return s;
+}
 
-    // Most-significant limb: variable number of digits
-    {
-        char buf[kDigitsPerLimb];
-        int n = 0;
-        uint64_t v = limbs[nlimbs - 1];
-        do {
-            buf[n++] = b58Alphabet[v % 58];
-            v /= 58;
-        } while (v > 0);
-        for (int k = n - 1; k >= 0; k--) {
-            result[pos++] = buf[k];
-        }
-    }
+namespace {
 
-    // Remaining limbs: each produces exactly kDigitsPerLimb digits
-    for (int i = nlimbs - 2; i >= 0; i--) {
-        char buf[kDigitsPerLimb];
-        uint64_t v = limbs[i];
-        for (int d = 0; d < kDigitsPerLimb; d++) {
-            buf[d] = b58Alphabet[v % 58];
-            v /= 58;
-        }
-        for (int k = kDigitsPerLimb - 1; k >= 0; k--) {
-            result[pos++] = buf[k];
-        }
+ParseStatus toStatus(base58::Check check) {
+    switch (check) {
+    case base58::Check::Ok:
+        return ParseStatus::Ok;
+    case base58::Check::BadLength:
+        return ParseStatus::BadLength;
+    case base58::Check::BadPrefix:
+        return ParseStatus::BadPrefix;
+    case base58::Check::BadDigit:
+        return ParseStatus::BadDigit;
+    case base58::Check::Overflow:
+        break;
     }
-
-    return std::string(result, pos);
+    return ParseStatus::Overflow;
 }
 
-// Decode: limbs in base 256^8 = 18,446,744,073,709,551,616 would overflow,
-// so we use 256^7 = 72,057,594,037,927,936. Max intermediate:
-// (256^7 - 1) * 58 + 57 < 2^64. Safe.
-constexpr int kBytesPerLimb = 7;
-constexpr uint64_t POW256 = 72057594037927936ULL; // 256^7
-constexpr int kDecodeMaxLimbs = 10; // ceil(64/7) = 10
-
-bool base58Decode(const char *str, size_t slen, uint8_t *out, size_t outlen) {
-    uint64_t limbs[kDecodeMaxLimbs] = {};
-    int nlimbs = 0;
-
-    for (size_t i = 0; i < slen; i++) {
-        auto c = static_cast<unsigned char>(str[i]);
-        if (c >= 128 || b58Reverse[c] == 255) {
-            return false;
-        }
-        uint64_t carry = b58Reverse[c];
-        for (int j = 0; j < nlimbs; j++) {
-            uint64_t acc = limbs[j] * 58 + carry;
-            limbs[j] = acc % POW256;
-            carry = acc / POW256;
-        }
-        while (carry > 0) {
-            if (nlimbs >= kDecodeMaxLimbs) {
-                return false;
-            }
-            limbs[nlimbs++] = carry % POW256;
-            carry /= POW256;
-        }
-    }
-
-    // Extract bytes from limbs into a temp buffer.
-    uint8_t temp[kDecodeMaxLimbs * kBytesPerLimb];
-    int tpos = 0;
-
-    if (nlimbs == 0) {
-        std::memset(out, 0, outlen);
-        return true;
+[[noreturn]] void throwParseError(ParseStatus status) {
+    switch (status) {
+    case ParseStatus::BadLength:
+        throw std::invalid_argument("invalid C4 ID length");
+    case ParseStatus::BadPrefix:
+        throw std::invalid_argument("C4 ID must start with 'c4'");
+    default:
+        throw std::invalid_argument("invalid base58 in C4 ID");
     }
+}
 
-    // Most-significant limb: variable number of bytes
-    {
-        uint8_t buf[kBytesPerLimb];
-        int n = 0;
-        uint64_t v = limbs[nlimbs - 1];
-        do {
-            buf[n++] = static_cast<uint8_t>(v & 0xff);
-            v >>= 8;
-        } while (v > 0);
-        for (int k = n - 1; k >= 0; k--) {
-            temp[tpos++] = buf[k];
-        }
-    }
+} // anonymous namespace
 
-    // Remaining limbs: each produces exactly kBytesPerLimb bytes
-    for (int i = nlimbs - 2; i >= 0; i--) {
-        uint8_t buf[kBytesPerLimb];
-        uint64_t v = limbs[i];
-        for (int d = 0; d < kBytesPerLimb; d++) {
-            buf[d] = static_cast<uint8_t>(v & 0xff);
-            v >>= 8;
-        }
-        for (int k = kBytesPerLimb - 1; k >= 0; k--) {
-            temp[tpos++] = buf[k];
-        }
+ParseStatus ID::TryParse(std::string_view str, ID &out) noexcept {
+    auto status = toStatus(base58::Validate(str.data(), str.size()));
+    if (status == ParseStatus::Ok) {
+        base58::Decode(str.data() + 2, out.digest_.data());
     }
+    return status;
+}
 
-    if (static_cast<size_t>(tpos) > outlen) {
-        return false;
+ID ID::Parse(std::string_view str) {
+    ID id;
+    auto status = TryParse(str, id);
+    if (status != ParseStatus::Ok) {
+        throwParseError(status);
     }
-
-    // Zero-pad front, copy into output
-    size_t pad = outlen - static_cast<size_t>(tpos);
-    std::memset(out, 0, pad);
-    std::memcpy(out + pad, temp, tpos);
-    return true;
+    return id;
 }
 
-} // anonymous namespace
-
-namespace c4 {
+bool IsValidIDString(std::string_view str) noexcept {
+    return base58::Validate(str.data(), str.size()) == base58::Check::Ok;
+}
 
-std::string ID::String() const {
-    std::string encoded = base58Encode(digest_.data(), digest_.size());
-    // Pad to exactly 88 characters with '1' (base58 zero) — matches Go behavior
-    if (encoded.size() < 88) {
-        encoded.insert(0, 88 - encoded.size(), '1');
+void EncodeIDs(const ID *ids, size_t count, char *out) {
+    constexpr size_t kChunk = 256;
+    const uint8_t *digests[kChunk];
+    char *digits[kChunk];
+    for (size_t base = 0; base < count; base += kChunk) {
+        size_t n = std::min(kChunk, count - base);
+        for (size_t i = 0; i < n; i++) {
+            char *p = out + (base + i) * IDLen;
+            p[0] = 'c';
+            p[1] = '4';
+            digests[i] = ids[base + i].digest_.data();
+            digits[i] = p + 2;
+        }
+        base58::EncodeMany(digests, n, digits);
     }
-    return "c4" + encoded;
 }
 
-ID ID::Parse(std::string_view str) {
-    if (str.size() != IDLen) {
-        throw std::invalid_argument("invalid C4 ID length");
-    }
-    if (str[0] != 'c' || str[1] != '4') {
-        throw std::invalid_argument("C4 ID must start with 'c4'");
-    }
-    ID id;
-    auto payload = str.substr(2);
-    if (!base58Decode(payload.data(), payload.size(),
-                      id.digest_.data(), id.digest_.size())) {
-        throw std::invalid_argument("invalid base58 in C4 ID");
+void ParseIDs(const char *str, size_t count, ID *out) {
+    constexpr size_t kChunk = 256;
+    const char *digits[kChunk];
+    uint8_t *digests[kChunk];
+    for (size_t base = 0; base < count; base += kChunk) {
+        size_t n = std::min(kChunk, count - base);
+        for (size_t i = 0; i < n; i++) {
+            const char *p = str + (base + i) * IDLen;
+            auto status = toStatus(base58::Validate(p, IDLen));
+            if (status != ParseStatus::Ok) {
+                throwParseError(status);
+            }
+            digits[i] = p + 2;
+            digests[i] = out[base + i].digest_.data();
+        }
+        base58::DecodeMany(digits, n, digests);
     }
-    return id;
 }
 
 } // namespace c4
@@ -247,13 +155,30 @@ c4_error_t c4_identify(const void *data, size_t len, c4_id_t *out) {
     }
 }
 
+c4_error_t c4_identify_many(const void *const *data, const size_t *lens,
+                            size_t count, c4_id_t **out) {
+    if (count == 0) return C4_OK;
+    if (!data || !lens || !out) return C4_ERR_INVALID_INPUT;
+    try {
+        std::vector<std::string_view> inputs(count);
+        for (size_t i = 0; i < count; i++) {
+            if (!out[i] || (!data[i] && lens[i] != 0)) return C4_ERR_INVALID_INPUT;
+            inputs[i] = std::string_view(static_cast<const char *>(data[i]), lens[i]);
+        }
+        auto ids = c4::ID::IdentifyBatch(inputs);
+        for (size_t i = 0; i < count; i++)
+            std::memcpy(out[i]->digest.data(), ids[i].Digest().data(), c4::DigestLen);
+        return C4_OK;
+    } catch (...) {
+        return C4_ERR_IO;
+    }
+}
+
 c4_error_t c4_id_string(const c4_id_t *id, char *buf, size_t buflen) {
     if (!id || !buf || buflen < c4::IDLen + 1) return C4_ERR_INVALID_INPUT;
     try {
         auto cpp_id = c4::ID::FromDigest(id->digest.data(), id->digest.size());
-        std::string encoded = cpp_id.String();
-        if (encoded.size() != c4::IDLen) return C4_ERR_INVALID_ID;
-        std::memcpy(buf, encoded.c_str(), c4::IDLen);
+        cpp_id.EncodeTo(buf);
         buf[c4::IDLen] = '\0';
         return C4_OK;
     } catch (...) {
@@ -263,13 +188,12 @@ c4_error_t c4_id_string(const c4_id_t *id, char *buf, size_t buflen) {
 
 c4_error_t c4_id_parse(const char *str, size_t len, c4_id_t *out) {
     if (!str || !out) return C4_ERR_INVALID_INPUT;
-    try {
-        auto id = c4::ID::Parse(std::string_view(str, len));
-        std::memcpy(out->digest.data(), id.Digest().data(), c4::DigestLen);
-        return C4_OK;
-    } catch (...) {
+    c4::ID id;
+    if (c4::ID::TryParse(std::string_view(str, len), id) != c4::ParseStatus::Ok) {
         return C4_ERR_INVALID_ID;
     }
+    std::memcpy(out->digest.data(), id.Digest().data(), c4::DigestLen);
+    return C4_OK;
 }
 
 int c4_id_compare(const c4_id_t *a, const c4_id_t *b) {
@@ -320,17 +244,13 @@ c4_error_t c4_identify_file(const char *path, c4_id_t *out) {
 }
 
 c4_error_t c4_identify_fd(int fd, c4_id_t *out) {
+    return c4_identify_fd_hint(fd, 0, out);
+}
+
+c4_error_t c4_identify_fd_hint(int fd, uint64_t size_hint, c4_id_t *out) {
     if (!out || fd < 0) return C4_ERR_INVALID_INPUT;
     try {
-        // Read all data from fd, then use standard Identify
-        std::string buf;
-        char tmp[262144];
-        ssize_t n;
-        while ((n = read(fd, tmp, sizeof(tmp))) > 0)
-            buf.append(tmp, static_cast<size_t>(n));
-        if (n < 0)
-            return C4_ERR_IO;
-        auto id = c4::ID::Identify(buf);
+        auto id = c4::ID::IdentifyFd(fd, size_hint);
         std::memcpy(out->digest.data(), id.Digest().data(), c4::DigestLen);
         return C4_OK;
     } catch (...) {
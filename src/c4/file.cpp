@@ -0,0 +1,448 @@
+// SPDX-License-Identifier: Apache-2.0
+// File identification: ID::IdentifyFile and its I/O backends.
+//
+//   Stream  std::ifstream; the portable baseline.
+//   Mmap    Zero-copy; the kernel reads ahead under MADV_SEQUENTIAL.
+//   Pread   4 MiB aligned chunks. For multi-chunk files a reader thread
+//           fills one buffer while the caller hashes the other, so disk
+//           latency overlaps hashing.
+//   Direct  Pread through O_DIRECT (F_NOCACHE on macOS). Where the
+//           filesystem refuses O_DIRECT, pages are dropped with
+//           POSIX_FADV_DONTNEED as each chunk is hashed instead.
+//
+// IdentifyFiles spreads many files over a worker pool. Small files take a
+// fast path: openat against a cached directory descriptor and one read
+// into a per-thread buffer. With several workers, one file's read overlaps
+// another's hashing.
+
+#include "c4/c4.hpp"
+#include "c4/c4m.hpp"
+#include "parallel.h"
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+c4::ID identifyStream(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("cannot open file: " + path.string());
+    }
+    return c4::ID::Identify(file);
+}
+
+#ifndef _WIN32
+
+constexpr uint64_t kSmallFile = 1 << 20;  // Auto: single read up to here
+constexpr uint64_t kMmapMax = 1ULL << 30; // Auto: mmap up to here
+constexpr size_t kChunk = 4 << 20;        // Pread/Direct chunk size
+constexpr size_t kAlign = 4096;           // O_DIRECT buffer and length alignment
+constexpr size_t kSmallRead = 64 << 10;   // per-thread buffer for small files
+
+std::runtime_error ioError(const char *what, const std::filesystem::path &path) {
+    return std::runtime_error(std::string(what) + ": " + path.string() + ": " +
+                              std::strerror(errno));
+}
+
+class File {
+public:
+    explicit File(int fd) : fd_(fd) {}
+    ~File() {
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+    File(const File &) = delete;
+    File &operator=(const File &) = delete;
+
+    int fd() const { return fd_; }
+
+private:
+    int fd_;
+};
+
+class AlignedBuffer {
+public:
+    explicit AlignedBuffer(size_t len) {
+        if (posix_memalign(&p_, kAlign, len) != 0)
+            throw std::bad_alloc();
+    }
+    ~AlignedBuffer() { std::free(p_); }
+    AlignedBuffer(const AlignedBuffer &) = delete;
+    AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+    char *data() const { return static_cast<char *>(p_); }
+
+private:
+    void *p_ = nullptr;
+};
+
+// Open name relative to dirfd (AT_FDCWD for plain paths). For direct reads
+// where the filesystem refuses O_DIRECT (e.g. tmpfs), open normally and set
+// drop_cache instead.
+int openFile(int dirfd, const char *name, bool direct, bool &drop_cache) {
+    int flags = O_RDONLY | O_CLOEXEC;
+#ifdef O_DIRECT
+    if (direct) {
+        int fd = ::openat(dirfd, name, flags | O_DIRECT);
+        if (fd >= 0 || errno != EINVAL)
+            return fd;
+        drop_cache = true;
+    }
+#endif
+    int fd = ::openat(dirfd, name, flags);
+#ifdef F_NOCACHE
+    if (fd >= 0 && direct)
+        fcntl(fd, F_NOCACHE, 1);
+#endif
+    return fd;
+}
+
+// pread until len bytes or EOF. Returns the byte count, or -1 with errno set.
+// direct says O_DIRECT is in effect on fd. A short O_DIRECT read is EOF:
+// reading on from its unaligned end would only fail with EINVAL. If the
+// first, aligned O_DIRECT read is rejected, O_DIRECT is cleared and
+// drop_cache set instead.
+long preadFull(int fd, char *buf, size_t len, off_t off, bool &direct, bool &drop_cache) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = ::pread(fd, buf + got, len - got, off + static_cast<off_t>(got));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+#ifdef O_DIRECT
+            if (direct && got == 0 && errno == EINVAL) {
+                int fl = fcntl(fd, F_GETFL);
+                if (fl >= 0 && fcntl(fd, F_SETFL, fl & ~O_DIRECT) == 0) {
+                    direct = false;
+                    drop_cache = true;
+                    continue;
+                }
+                errno = EINVAL;
+            }
+#endif
+            return -1;
+        }
+        if (n == 0)
+            break;
+        got += static_cast<size_t>(n);
+        if (direct && got < len)
+            break;
+    }
+    return static_cast<long>(got);
+}
+
+void dropCache(int fd, off_t off, long len) {
+#ifdef POSIX_FADV_DONTNEED
+    posix_fadvise(fd, off, len, POSIX_FADV_DONTNEED);
+#else
+    (void)fd; (void)off; (void)len;
+#endif
+}
+
+// Two-slot read pipeline: a reader thread preads chunk k into slot k % 2
+// while the caller hashes the other slot.
+class ReadPipeline {
+public:
+    ReadPipeline(int fd, bool direct, bool drop_cache)
+        : fd_(fd), direct_(direct), drop_cache_(drop_cache),
+          reader_([this] { run(); }) {}
+
+    ~ReadPipeline() {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        reader_.join();
+    }
+
+    // Release the previous chunk and wait for the next one. Returns its
+    // length (0 at EOF), or -1 with errno set on a read error.
+    long Next(const char **data) {
+        std::unique_lock<std::mutex> lock(mu_);
+        if (next_ > 0) {
+            filled_[(next_ - 1) & 1] = kEmpty;
+            cv_.notify_all();
+        }
+        if (eof_seen_)
+            return 0;
+        int slot = next_ & 1;
+        cv_.wait(lock, [&] { return filled_[slot] != kEmpty; });
+        long n = filled_[slot];
+        if (n < 0) {
+            errno = errno_;
+            return -1;
+        }
+        next_++;
+        eof_seen_ = n < static_cast<long>(kChunk);
+        *data = buf_[slot].data();
+        return n;
+    }
+
+private:
+    static constexpr long kEmpty = -2;
+
+    void run() {
+        off_t off = 0;
+        for (size_t k = 0;; k++) {
+            int slot = k & 1;
+            {
+                std::unique_lock<std::mutex> lock(mu_);
+                cv_.wait(lock, [&] { return stop_ || filled_[slot] == kEmpty; });
+                if (stop_)
+                    return;
+            }
+            long n = preadFull(fd_, buf_[slot].data(), kChunk, off, direct_, drop_cache_);
+            int err = errno;
+            if (n > 0 && drop_cache_)
+                dropCache(fd_, off, n);
+            {
+                std::lock_guard<std::mutex> lock(mu_);
+                filled_[slot] = n;
+                errno_ = err;
+            }
+            cv_.notify_all();
+            // A short read is EOF; the caller stops after this chunk.
+            if (n < static_cast<long>(kChunk))
+                return;
+            off += n;
+        }
+    }
+
+    int fd_;
+    bool direct_;     // reader thread only
+    bool drop_cache_; // reader thread only
+    AlignedBuffer buf_[2] = {AlignedBuffer(kChunk), AlignedBuffer(kChunk)};
+    std::mutex mu_;
+    std::condition_variable cv_;
+    long filled_[2] = {kEmpty, kEmpty};
+    int errno_ = 0;
+    bool stop_ = false;
+    size_t next_ = 0;
+    bool eof_seen_ = false;
+    std::thread reader_; // last: starts after the members above exist
+};
+
+c4::ID identifyPread(int fd, uint64_t size, bool direct, bool drop_cache,
+                     const std::filesystem::path &path) {
+    if (size < kChunk) {
+        // Fits in one chunk: read synchronously. One extra aligned block
+        // lets the read observe EOF even if the file grew since fstat.
+        // Small files share a per-thread buffer instead of allocating.
+        size_t len = (static_cast<size_t>(size) + kAlign) / kAlign * kAlign;
+        thread_local AlignedBuffer small_buf(kSmallRead);
+        std::unique_ptr<AlignedBuffer> large_buf;
+        char *buf = small_buf.data();
+        if (len > kSmallRead) {
+            large_buf = std::make_unique<AlignedBuffer>(len);
+            buf = large_buf->data();
+        }
+        off_t off = 0;
+        long n = preadFull(fd, buf, len, off, direct, drop_cache);
+        if (n < 0)
+            throw ioError("read failed", path);
+        if (drop_cache && n > 0)
+            dropCache(fd, off, n);
+        // The usual case: the whole file came back in one read, so hash it
+        // with the thread's reusable context rather than a fresh Hasher.
+        if (n < static_cast<long>(len))
+            return c4::ID::Identify(buf, static_cast<size_t>(n));
+
+        c4::Hasher hasher;
+        for (;;) {
+            hasher.Update(buf, static_cast<size_t>(n));
+            if (n < static_cast<long>(len))
+                break;
+            off += n;
+            n = preadFull(fd, buf, len, off, direct, drop_cache);
+            if (n < 0)
+                throw ioError("read failed", path);
+            if (drop_cache && n > 0)
+                dropCache(fd, off, n);
+        }
+        return hasher.Finalize();
+    }
+
+    c4::Hasher hasher;
+    ReadPipeline pipeline(fd, direct, drop_cache);
+    const char *data = nullptr;
+    for (;;) {
+        long n = pipeline.Next(&data);
+        if (n < 0)
+            throw ioError("read failed", path);
+        if (n == 0)
+            break;
+        hasher.Update(data, static_cast<size_t>(n));
+    }
+    return hasher.Finalize();
+}
+
+c4::ID identifyMmap(int fd, uint64_t size, const std::filesystem::path &path) {
+    if (size == 0)
+        return c4::ID::Identify("", 0);
+    // A file truncated while mapped raises SIGBUS; this is the usual mmap
+    // trade-off and why Auto stops using it for very large files.
+    void *p = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED)
+        return identifyPread(fd, size, false, false, path);
+    ::madvise(p, static_cast<size_t>(size), MADV_SEQUENTIAL);
+    try {
+        c4::ID id = c4::ID::Identify(p, static_cast<size_t>(size));
+        ::munmap(p, static_cast<size_t>(size));
+        return id;
+    } catch (...) {
+        ::munmap(p, static_cast<size_t>(size));
+        throw;
+    }
+}
+
+// Identify an open file, choosing the backend for io by file size.
+c4::ID identifyOpen(int fd, c4::IOStrategy io, bool drop_cache,
+                    const std::filesystem::path &path) {
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        throw ioError("cannot stat file", path);
+    if (!S_ISREG(st.st_mode))
+        return c4::ID::IdentifyFd(fd);
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+
+    if (io == c4::IOStrategy::Auto) {
+        if (size <= kSmallFile || size > kMmapMax)
+            io = c4::IOStrategy::Pread;
+        else
+            io = c4::IOStrategy::Mmap;
+    }
+
+    if (io == c4::IOStrategy::Mmap)
+        return identifyMmap(fd, size, path);
+    // openFile sets drop_cache when it had to fall back from O_DIRECT.
+    bool direct = false;
+#ifdef O_DIRECT
+    direct = io == c4::IOStrategy::Direct && !drop_cache;
+#endif
+    return identifyPread(fd, size, direct, drop_cache, path);
+}
+
+// Parent-directory descriptor reused across consecutive files in the same
+// directory, so each file costs one openat of its bare name.
+class DirCache {
+public:
+    DirCache() = default;
+    ~DirCache() {
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+    DirCache(const DirCache &) = delete;
+    DirCache &operator=(const DirCache &) = delete;
+
+    // Descriptor for dir, or -1 if it cannot be opened.
+    int Get(const std::filesystem::path &dir) {
+        if (fd_ >= 0 && dir == dir_)
+            return fd_;
+        if (fd_ >= 0)
+            ::close(fd_);
+        fd_ = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        dir_ = dir;
+        return fd_;
+    }
+
+private:
+    int fd_ = -1;
+    std::filesystem::path dir_;
+};
+
+#endif // !_WIN32
+
+} // anonymous namespace
+
+namespace c4 {
+
+ID ID::IdentifyFile(const std::filesystem::path &path) {
+    return IdentifyFile(path, IdentifyOptions{});
+}
+
+ID ID::IdentifyFile(const std::filesystem::path &path, const IdentifyOptions &options) {
+    // For .c4m files, use c4m-aware identification
+    if (path.extension() == ".c4m") {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("cannot open file: " + path.string());
+        }
+        std::string content((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+        // .c4m extension: skip Phase 1, go directly to Phase 2 parse attempt
+        std::string canonical = c4m::CanonicalizeC4m(content);
+        if (!canonical.empty())
+            return Identify(canonical);
+        // Parse failed: fall through to raw byte hash
+        return Identify(content);
+    }
+
+#ifdef _WIN32
+    (void)options;
+    return identifyStream(path);
+#else
+    if (options.io == IOStrategy::Stream)
+        return identifyStream(path);
+
+    bool drop_cache = false;
+    File file(openFile(AT_FDCWD, path.c_str(), options.io == IOStrategy::Direct, drop_cache));
+    if (file.fd() < 0)
+        throw ioError("cannot open file", path);
+    return identifyOpen(file.fd(), options.io, drop_cache, path);
+#endif
+}
+
+std::vector<ID> IdentifyFiles(const std::vector<std::filesystem::path> &paths,
+                              const IdentifyOptions &options) {
+    std::vector<ID> ids(paths.size());
+
+    // Blocks of consecutive paths per task: inputs listed directory by
+    // directory keep hitting the same cached directory descriptor.
+    constexpr size_t kGrain = 32;
+    detail::ParallelFor(paths.size(), options.threads, kGrain, [&](size_t begin, size_t end) {
+#ifdef _WIN32
+        for (size_t i = begin; i < end; i++)
+            ids[i] = ID::IdentifyFile(paths[i], options);
+#else
+        DirCache dirs;
+        for (size_t i = begin; i < end; i++) {
+            const auto &path = paths[i];
+            if (options.io == IOStrategy::Stream || path.extension() == ".c4m" ||
+                !path.has_filename()) {
+                ids[i] = ID::IdentifyFile(path, options);
+                continue;
+            }
+            int dirfd = dirs.Get(path.parent_path());
+            if (dirfd < 0)
+                throw ioError("cannot open directory", path.parent_path());
+            bool drop_cache = false;
+            File file(openFile(dirfd, path.filename().c_str(),
+                               options.io == IOStrategy::Direct, drop_cache));
+            if (file.fd() < 0)
+                throw ioError("cannot open file", path);
+            ids[i] = identifyOpen(file.fd(), options.io, drop_cache, path);
+        }
+#endif
+    });
+    return ids;
+}
+
+} // namespace c4
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: Apache-2.0
+// Incremental hashing: c4::Hasher and the c4_hasher_t C API.
+//
+// Each hasher owns its EVP_MD_CTX, so many hashers can be live at once on
+// the same thread (unlike ID::Identify's thread-local context).
+
+#include "c4/c4.hpp"
+#include "c4/c4.h"
+#include "internal.h"
+
+#include <openssl/evp.h>
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace c4 {
+
+struct Hasher::Impl {
+    EVP_MD_CTX *ctx = nullptr;
+
+    Impl() : ctx(EVP_MD_CTX_new()) {
+        if (!ctx) {
+            throw std::runtime_error("failed to create digest context");
+        }
+    }
+    ~Impl() { EVP_MD_CTX_free(ctx); }
+
+    void Init() {
+        if (EVP_DigestInit_ex(ctx, EVP_sha512(), nullptr) != 1) {
+            throw std::runtime_error("SHA-512 init failed");
+        }
+    }
+};
+
+Hasher::Hasher() : impl_(std::make_unique<Impl>()) {
+    impl_->Init();
+}
+
+Hasher::~Hasher() = default;
+Hasher::Hasher(Hasher &&other) noexcept = default;
+Hasher &Hasher::operator=(Hasher &&other) noexcept = default;
+
+void Hasher::Update(const void *data, size_t len) {
+    if (EVP_DigestUpdate(impl_->ctx, data, len) != 1) {
+        throw std::runtime_error("SHA-512 update failed");
+    }
+}
+
+void Hasher::Update(std::string_view data) {
+    Update(data.data(), data.size());
+}
+
+ID Hasher::Finalize() {
+    uint8_t digest[DigestLen];
+    unsigned int digest_len = 0;
+    if (EVP_DigestFinal_ex(impl_->ctx, digest, &digest_len) != 1) {
+        throw std::runtime_error("SHA-512 finalize failed");
+    }
+    impl_->Init();
+    return ID::FromDigest(digest, DigestLen);
+}
+
+void Hasher::Reset() {
+    impl_->Init();
+}
+
+} // namespace c4
+
+// C API
+struct c4_hasher {
+    c4::Hasher hasher;
+};
+
+extern "C" {
+
+c4_hasher_t *c4_hasher_new(void) {
+    try {
+        return new c4_hasher_t;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void c4_hasher_free(c4_hasher_t *h) {
+    delete h;
+}
+
+c4_error_t c4_hasher_update(c4_hasher_t *h, const void *data, size_t len) {
+    if (!h || (!data && len != 0)) return C4_ERR_INVALID_INPUT;
+    try {
+        h->hasher.Update(data, len);
+        return C4_OK;
+    } catch (...) {
+        return C4_ERR_IO;
+    }
+}
+
+c4_error_t c4_hasher_final(c4_hasher_t *h, c4_id_t *out) {
+    if (!h || !out) return C4_ERR_INVALID_INPUT;
+    try {
+        auto id = h->hasher.Finalize();
+        std::memcpy(out->digest.data(), id.Digest().data(), c4::DigestLen);
+        return C4_OK;
+    } catch (...) {
+        return C4_ERR_IO;
+    }
+}
+
+c4_error_t c4_hasher_reset(c4_hasher_t *h) {
+    if (!h) return C4_ERR_INVALID_INPUT;
+    try {
+        h->hasher.Reset();
+        return C4_OK;
+    } catch (...) {
+        return C4_ERR_IO;
+    }
+}
+
+} // extern "C"
@@ -2,33 +2,85 @@
 #include "c4/c4.hpp"
 #include "c4/c4.h"
 #include "c4/c4m.hpp"
+#include "sha512.h"
 
 #include <openssl/evp.h>
 
 #include <algorithm>
+#include <cerrno>
 #include <cstring>
-#include <fstream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
 
 namespace {
 
 // Thread-local EVP_MD_CTX reuse. Allocated once per thread, never freed
 // during the thread's lifetime. Avoids repeated malloc/free in hot paths
-// (Sum, Identify). Reset between uses via EVP_DigestInit_ex.
+// (Identify, IdentifyFd). Reset between uses via EVP_DigestInit_ex.
 EVP_MD_CTX *getThreadCtx() {
     thread_local EVP_MD_CTX *ctx = EVP_MD_CTX_new();
     return ctx;
 }
 
-} // anonymous namespace
+// read(2) with EINTR retry.
+long readFd(int fd, char *buf, size_t len) {
+    for (;;) {
+#ifdef _WIN32
+        long n = _read(fd, buf, static_cast<unsigned int>(len));
+#else
+        long n = static_cast<long>(::read(fd, buf, len));
+#endif
+        if (n >= 0 || errno != EINTR)
+            return n;
+    }
+}
 
-namespace c4 {
+// Hash n ID pairs through sha512::DigestPairs, a chunk at a time.
+// pair(i, a, b) yields the digests of pair i and dst(i) its output. As in
+// ID::Sum, the smaller digest goes first and equal inputs are copied.
+template <class PairFn, class DstFn>
+void sumPairs(size_t n, PairFn pair, DstFn dst) {
+    constexpr size_t kChunk = 256;
+    const uint8_t *first[kChunk];
+    const uint8_t *second[kChunk];
+    uint8_t *out[kChunk];
 
-ID::ID() {
-    digest_.fill(0);
+    for (size_t base = 0; base < n; base += kChunk) {
+        size_t end = std::min(n, base + kChunk);
+        size_t m = 0;
+        for (size_t i = base; i < end; i++) {
+            const uint8_t *a;
+            const uint8_t *b;
+            pair(i, a, b);
+            uint8_t *d = dst(i);
+            int cmp = std::memcmp(a, b, c4::DigestLen);
+            if (cmp == 0) {
+                if (d != a)
+                    std::memcpy(d, a, c4::DigestLen);
+                continue;
+            }
+            first[m] = cmp < 0 ? a : b;
+            second[m] = cmp < 0 ? b : a;
+            out[m++] = d;
+        }
+        c4::sha512::DigestPairs(first, second, m, out);
+    }
 }
 
+} // anonymous namespace
+
+namespace c4 {
+
 ID ID::Identify(const void *data, size_t len) {
     ID id;
     EVP_MD_CTX *ctx = getThreadCtx();
@@ -48,6 +100,36 @@ ID ID::Identify(std::string_view data) {
     return Identify(data.data(), data.size());
 }
 
+void ID::IdentifyBatch(const std::string_view *inputs, size_t count, ID *out) {
+    // Inputs above this size gain nothing from sharing SIMD lanes; a single
+    // OpenSSL stream is faster for them.
+    constexpr size_t kMaxLaneInput = 16384;
+
+    std::vector<const uint8_t *> data;
+    std::vector<size_t> lens;
+    std::vector<uint8_t *> digests;
+    data.reserve(count);
+    lens.reserve(count);
+    digests.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        if (inputs[i].size() > kMaxLaneInput) {
+            out[i] = Identify(inputs[i]);
+            continue;
+        }
+        data.push_back(reinterpret_cast<const uint8_t *>(inputs[i].data()));
+        lens.push_back(inputs[i].size());
+        digests.push_back(out[i].digest_.data());
+    }
+    sha512::DigestMany(data.data(), lens.data(), data.size(), digests.data());
+}
+
+std::vector<ID> ID::IdentifyBatch(const std::vector<std::string_view> &inputs) {
+    std::vector<ID> out(inputs.size());
+    IdentifyBatch(inputs.data(), inputs.size(), out.data());
+    return out;
+}
+
 ID ID::Identify(std::istream &stream) {
     EVP_MD_CTX *ctx = getThreadCtx();
     if (!ctx) {
@@ -87,28 +169,69 @@ ID ID::IdentifyC4mAware(std::string_view data) {
     return Identify(data);
 }
 
-ID ID::IdentifyFile(const std::filesystem::path &path) {
-    // For .c4m files, use c4m-aware identification
-    if (path.extension() == ".c4m") {
-        std::ifstream file(path, std::ios::binary);
-        if (!file) {
-            throw std::runtime_error("cannot open file: " + path.string());
+ID ID::IdentifyFd(int fd, uint64_t size_hint) {
+    if (fd < 0) {
+        throw std::invalid_argument("invalid file descriptor");
+    }
+    EVP_MD_CTX *ctx = getThreadCtx();
+    if (!ctx) {
+        throw std::runtime_error("failed to create digest context");
+    }
+    if (EVP_DigestInit_ex(ctx, EVP_sha512(), nullptr) != 1) {
+        throw std::runtime_error("SHA-512 init failed");
+    }
+
+    // One reusable per-thread buffer: memory stays constant however much
+    // data the descriptor yields.
+    constexpr size_t kChunk = 1 << 20;
+    thread_local std::unique_ptr<char[]> buf(new char[kChunk]);
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    // Seekable descriptors get read-ahead hints, and pages already hashed
+    // are dropped so large inputs don't evict the rest of the page cache.
+    // Pipes and sockets fail lseek and skip all of this.
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    bool seekable = offset >= 0;
+    if (seekable) {
+        struct stat st;
+        if (size_hint == 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+            st.st_size > offset) {
+            size_hint = static_cast<uint64_t>(st.st_size - offset);
+        }
+        posix_fadvise(fd, offset, 0, POSIX_FADV_SEQUENTIAL);
+        if (size_hint > 0 && size_hint <= kChunk) {
+            posix_fadvise(fd, offset, static_cast<off_t>(size_hint), POSIX_FADV_WILLNEED);
         }
-        std::string content((std::istreambuf_iterator<char>(file)),
-                             std::istreambuf_iterator<char>());
-        // .c4m extension: skip Phase 1, go directly to Phase 2 parse attempt
-        std::string canonical = c4m::CanonicalizeC4m(content);
-        if (!canonical.empty())
-            return Identify(canonical);
-        // Parse failed: fall through to raw byte hash
-        return Identify(content);
     }
+#else
+    (void)size_hint;
+#endif
 
-    std::ifstream file(path, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("cannot open file: " + path.string());
+    for (;;) {
+        long n = readFd(fd, buf.get(), kChunk);
+        if (n < 0) {
+            throw std::runtime_error(std::string("read failed: ") + std::strerror(errno));
+        }
+        if (n == 0) {
+            break;
+        }
+        if (EVP_DigestUpdate(ctx, buf.get(), static_cast<size_t>(n)) != 1) {
+            throw std::runtime_error("SHA-512 update failed");
+        }
+#ifdef POSIX_FADV_DONTNEED
+        if (seekable) {
+            posix_fadvise(fd, offset, n, POSIX_FADV_DONTNEED);
+            offset += n;
+        }
+#endif
     }
-    return Identify(file);
+
+    ID id;
+    unsigned int digest_len = 0;
+    if (EVP_DigestFinal_ex(ctx, id.digest_.data(), &digest_len) != 1) {
+        throw std::runtime_error("SHA-512 finalize failed");
+    }
+    return id;
 }
 
 ID ID::FromDigest(const uint8_t *data, size_t len) {
@@ -130,22 +253,30 @@ ID ID::Sum(const ID &other) const {
     const ID &larger  = (cmp < 0) ? other : *this;
 
     ID result;
-    EVP_MD_CTX *ctx = getThreadCtx();
-    if (!ctx) {
-        throw std::runtime_error("failed to create digest context");
-    }
-    unsigned int digest_len = 0;
-    if (EVP_DigestInit_ex(ctx, EVP_sha512(), nullptr) != 1 ||
-        EVP_DigestUpdate(ctx, smaller.digest_.data(), DigestLen) != 1 ||
-        EVP_DigestUpdate(ctx, larger.digest_.data(), DigestLen) != 1 ||
-        EVP_DigestFinal_ex(ctx, result.digest_.data(), &digest_len) != 1) {
-        throw std::runtime_error("SHA-512 digest failed");
-    }
+    sha512::DigestPair(smaller.digest_.data(), larger.digest_.data(), result.digest_.data());
     return result;
 }
 
-const std::array<uint8_t, DigestLen> &ID::Digest() const {
-    return digest_;
+void ID::SumPairs(const ID *left, const ID *right, ID *out, size_t n) {
+    sumPairs(
+        n,
+        [&](size_t i, const uint8_t *&a, const uint8_t *&b) {
+            a = left[i].digest_.data();
+            b = right[i].digest_.data();
+        },
+        [&](size_t i) { return out[i].digest_.data(); });
+}
+
+void ID::SumAdjacent(const ID *in, size_t count, ID *out) {
+    sumPairs(
+        count / 2,
+        [&](size_t i, const uint8_t *&a, const uint8_t *&b) {
+            a = in[2 * i].digest_.data();
+            b = in[2 * i + 1].digest_.data();
+        },
+        [&](size_t i) { return out[i].digest_.data(); });
+    if (count % 2)
+        out[count / 2] = in[count - 1];
 }
 
 bool ID::operator==(const ID &other) const {
@@ -166,7 +297,9 @@ bool ID::IsNil() const {
 }
 
 std::ostream &operator<<(std::ostream &os, const ID &id) {
-    return os << id.String();
+    char encoded[IDLen];
+    id.EncodeTo(encoded);
+    return os << std::string_view(encoded, IDLen);
 }
 
 } // namespace c4
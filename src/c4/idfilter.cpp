@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: Apache-2.0
+// IDFilter: blocked Bloom filter keyed by digest bits
+//
+// Digest bytes 0..3 select the block (multiply-shift onto the block
+// count, so any size works); each bit position inside the 512-bit block is
+// the low 9 bits of its own 16-bit slice of bytes 8..39. The bit array is
+// a plain byte array, so the file form is the same on every platform.
+
+#include "c4/idfilter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace c4 {
+
+namespace {
+
+constexpr size_t kBlockBytes = 64;
+constexpr unsigned kMaxHashes = 16;  // 16-bit slices of bytes 8..39
+
+constexpr char kMagic[8] = {'C', '4', 'I', 'D', 'F', 'L', 'T', 'R'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderLen = 64;
+
+void storeLE(uint8_t *p, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++)
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint64_t loadLE(const uint8_t *p, size_t bytes) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; i++)
+        v |= uint64_t{p[i]} << (8 * i);
+    return v;
+}
+
+// Bit position inside the block for hash i.
+unsigned bitOf(const uint8_t *digest, unsigned i) {
+    return (digest[8 + 2 * i] | (unsigned{digest[9 + 2 * i]} << 8)) & 511;
+}
+
+std::runtime_error ioError(const char *what, const std::filesystem::path &path) {
+    return std::runtime_error(std::string(what) + ": " + path.string() + ": " +
+                              std::strerror(errno));
+}
+
+} // anonymous namespace
+
+IDFilter::IDFilter(size_t expected, unsigned bits_per_id) {
+    if (bits_per_id < 1 || bits_per_id > 64) {
+        throw std::invalid_argument("bits per ID must be between 1 and 64");
+    }
+    // The optimum for a classic Bloom filter is bits * ln 2; a blocked
+    // filter does slightly better with one fewer.
+    k_ = static_cast<unsigned>(std::lround(bits_per_id * 0.693)) - 1;
+    k_ = k_ < 1 ? 1 : (k_ > kMaxHashes ? kMaxHashes : k_);
+
+    uint64_t bits = static_cast<uint64_t>(expected) * bits_per_id;
+    blocks_ = (bits + kBlockBytes * 8 - 1) / (kBlockBytes * 8);
+    if (blocks_ == 0) {
+        blocks_ = 1;
+    }
+    if (blocks_ > 0xFFFFFFFFu) {
+        throw std::length_error("IDFilter too large");
+    }
+    allocate(blocks_);
+}
+
+void IDFilter::Free::operator()(uint8_t *p) const noexcept {
+    ::operator delete(p, align);
+}
+
+// Cache-line aligned, zeroed bit array. Large arrays are aligned to 2 MiB
+// and, where the kernel offers it, backed by huge pages before they are
+// touched: lookups are random, so with 4 KiB pages nearly every one would
+// also miss the TLB.
+void IDFilter::allocate(uint64_t blocks) {
+    constexpr size_t kHuge = size_t{2} << 20;
+    const size_t bytes = static_cast<size_t>(blocks) * kBlockBytes;
+    const std::align_val_t align{bytes >= 2 * kHuge ? kHuge : kBlockBytes};
+    bits_ = std::unique_ptr<uint8_t[], Free>(
+        static_cast<uint8_t *>(::operator new(bytes, align)), Free{align});
+    bytes_ = bytes;
+#if defined(MADV_HUGEPAGE)
+    if (bytes >= 2 * kHuge)
+        ::madvise(bits_.get(), bytes & ~(kHuge - 1), MADV_HUGEPAGE);
+#endif
+    std::memset(bits_.get(), 0, bytes);
+}
+
+IDFilter IDFilter::Build(const IDs &ids, unsigned bits_per_id) {
+    IDFilter filter(ids.Size(), bits_per_id);
+    for (const auto &id : ids) {
+        filter.Add(id);
+    }
+    return filter;
+}
+
+size_t IDFilter::block(const ID &id) const {
+    uint64_t h = loadLE(id.Digest().data(), 4);
+    return static_cast<size_t>((h * blocks_) >> 32) * kBlockBytes;
+}
+
+void IDFilter::Add(const ID &id) {
+    if (!bits_) {
+        throw std::logic_error("IDFilter has no capacity");
+    }
+    uint8_t *b = bits_.get() + block(id);
+    const uint8_t *d = id.Digest().data();
+    for (unsigned i = 0; i < k_; i++) {
+        unsigned bit = bitOf(d, i);
+        b[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+    }
+}
+
+bool IDFilter::MayContain(const ID &id) const {
+    if (!bits_) {
+        return false;
+    }
+    const uint8_t *b = bits_.get() + block(id);
+    const uint8_t *d = id.Digest().data();
+    for (unsigned i = 0; i < k_; i++) {
+        unsigned bit = bitOf(d, i);
+        if (!(b[bit >> 3] & (1u << (bit & 7)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void IDFilter::MayContainMany(const ID *ids, size_t count, bool *out) const {
+    // Fetch the block a few IDs ahead while testing the current one, so
+    // the cache misses of independent lookups overlap.
+    constexpr size_t kAhead = 8;
+    if (!bits_) {
+        std::fill_n(out, count, false);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (i + kAhead < count) {
+            __builtin_prefetch(bits_.get() + block(ids[i + kAhead]));
+        }
+#endif
+        out[i] = MayContain(ids[i]);
+    }
+}
+
+void IDFilter::Write(const std::filesystem::path &path) const {
+    if (blocks_ == 0)
+        throw std::logic_error("IDFilter has no capacity");
+    uint8_t header[kHeaderLen] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    storeLE(header + 8, kVersion, 4);
+    storeLE(header + 12, k_, 4);
+    storeLE(header + 16, blocks_, 8);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw ioError("cannot create file", path);
+    out.write(reinterpret_cast<const char *>(header), kHeaderLen);
+    out.write(reinterpret_cast<const char *>(bits_.get()),
+              static_cast<std::streamsize>(bytes_));
+    out.flush();
+    if (!out)
+        throw ioError("write failed", path);
+}
+
+IDFilter IDFilter::Read(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw ioError("cannot open file", path);
+
+    uint8_t header[kHeaderLen];
+    if (!in.read(reinterpret_cast<char *>(header), kHeaderLen) ||
+        std::memcmp(header, kMagic, sizeof(kMagic)) != 0 || loadLE(header + 8, 4) != kVersion)
+        throw std::runtime_error("invalid ID filter: bad header: " + path.string());
+
+    IDFilter filter;
+    filter.k_ = static_cast<unsigned>(loadLE(header + 12, 4));
+    filter.blocks_ = loadLE(header + 16, 8);
+    if (filter.k_ < 1 || filter.k_ > kMaxHashes || filter.blocks_ < 1 ||
+        filter.blocks_ > 0xFFFFFFFFu)
+        throw std::runtime_error("invalid ID filter: bad parameters: " + path.string());
+
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec || size != kHeaderLen + filter.blocks_ * kBlockBytes)
+        throw std::runtime_error("invalid ID filter: size does not match: " + path.string());
+
+    filter.allocate(filter.blocks_);
+    if (!in.read(reinterpret_cast<char *>(filter.bits_.get()),
+                 static_cast<std::streamsize>(filter.bytes_)))
+        throw ioError("read failed", path);
+    return filter;
+}
+
+} // namespace c4
@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: Apache-2.0
+// IDList: memory-mapped binary ID sets (format in include/c4/idlist.hpp)
+
+#include "c4/idlist.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace c4 {
+
+namespace {
+
+constexpr char kMagic[8] = {'C', '4', 'I', 'D', 'L', 'I', 'S', 'T'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kFlagFanout = 1;
+constexpr size_t kHeaderLen = 64;
+constexpr size_t kFanoutLen = 256 * 8;
+
+void storeLE(uint8_t *p, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++)
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint64_t loadLE(const uint8_t *p, size_t bytes) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; i++)
+        v |= uint64_t{p[i]} << (8 * i);
+    return v;
+}
+
+std::runtime_error ioError(const char *what, const std::filesystem::path &path) {
+    return std::runtime_error(std::string(what) + ": " + path.string() + ": " +
+                              std::strerror(errno));
+}
+
+std::runtime_error formatError(const char *what, const std::filesystem::path &path) {
+    return std::runtime_error(std::string("invalid ID list: ") + what + ": " + path.string());
+}
+
+} // anonymous namespace
+
+void IDList::Write(const std::filesystem::path &path, const IDs &ids, bool fanout) {
+    IDs sorted;
+    const IDs *src = &ids;
+    if (!ids.SortedUnique()) {
+        sorted = ids;
+        sorted.SortUnique();
+        src = &sorted;
+    }
+
+    uint8_t header[kHeaderLen] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    storeLE(header + 8, kVersion, 4);
+    storeLE(header + 12, fanout ? kFlagFanout : 0, 4);
+    storeLE(header + 16, src->Size(), 8);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw ioError("cannot create file", path);
+    out.write(reinterpret_cast<const char *>(header), kHeaderLen);
+
+    if (fanout) {
+        uint64_t counts[256] = {};
+        for (const auto &id : *src)
+            counts[id.Digest()[0]]++;
+        uint8_t table[kFanoutLen];
+        uint64_t total = 0;
+        for (size_t b = 0; b < 256; b++) {
+            total += counts[b];
+            storeLE(table + 8 * b, total, 8);
+        }
+        out.write(reinterpret_cast<const char *>(table), kFanoutLen);
+    }
+
+    // IDs storage is contiguous digests, already in file order.
+    if (!src->Empty()) {
+        out.write(reinterpret_cast<const char *>((*src)[0].Digest().data()),
+                  static_cast<std::streamsize>(src->Size() * DigestLen));
+    }
+    out.flush();
+    if (!out)
+        throw ioError("write failed", path);
+}
+
+IDList IDList::Open(const std::filesystem::path &path) {
+    IDList list;
+    const uint8_t *data = nullptr;
+    size_t len = 0;
+
+#ifdef _WIN32
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw ioError("cannot open file", path);
+    list.buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data = list.buffer_.data();
+    len = list.buffer_.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw ioError("cannot open file", path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw ioError("cannot stat file", path);
+    }
+    len = static_cast<size_t>(st.st_size);
+    if (len > 0) {
+        void *p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw ioError("cannot map file", path);
+        }
+        list.map_ = p;
+        list.map_len_ = len;
+        data = static_cast<const uint8_t *>(p);
+    }
+    ::close(fd);
+#endif
+
+    if (len < kHeaderLen || std::memcmp(data, kMagic, sizeof(kMagic)) != 0)
+        throw formatError("bad header", path);
+    if (loadLE(data + 8, 4) != kVersion)
+        throw formatError("unsupported version", path);
+
+    const uint32_t flags = static_cast<uint32_t>(loadLE(data + 12, 4));
+    const uint64_t count = loadLE(data + 16, 8);
+    size_t offset = kHeaderLen;
+    if (flags & kFlagFanout) {
+        if (len < offset + kFanoutLen)
+            throw formatError("truncated fanout table", path);
+        uint64_t prev = 0;
+        for (size_t b = 0; b < 256; b++) {
+            uint64_t v = loadLE(data + offset + 8 * b, 8);
+            if (v < prev)
+                throw formatError("fanout table not ascending", path);
+            prev = v;
+        }
+        if (prev != count)
+            throw formatError("fanout table does not match count", path);
+        list.fanout_ = data + offset;
+        offset += kFanoutLen;
+    }
+    if (count > (len - offset) / DigestLen || len - offset != count * DigestLen)
+        throw formatError("size does not match count", path);
+
+    list.digests_ = data + offset;
+    list.count_ = static_cast<size_t>(count);
+    return list;
+}
+
+IDList::~IDList() {
+    release();
+}
+
+IDList::IDList(IDList &&other) noexcept {
+    *this = std::move(other);
+}
+
+IDList &IDList::operator=(IDList &&other) noexcept {
+    if (this != &other) {
+        release();
+        digests_ = std::exchange(other.digests_, nullptr);
+        count_ = std::exchange(other.count_, 0);
+        fanout_ = std::exchange(other.fanout_, nullptr);
+        map_ = std::exchange(other.map_, nullptr);
+        map_len_ = std::exchange(other.map_len_, 0);
+        buffer_ = std::move(other.buffer_);
+        other.buffer_.clear();
+    }
+    return *this;
+}
+
+void IDList::release() {
+#ifndef _WIN32
+    if (map_)
+        ::munmap(map_, map_len_);
+#endif
+    map_ = nullptr;
+    map_len_ = 0;
+    buffer_.clear();
+    digests_ = nullptr;
+    fanout_ = nullptr;
+    count_ = 0;
+}
+
+ID IDList::operator[](size_t i) const {
+    if (i >= count_)
+        throw std::out_of_range("IDList index out of range");
+    return ID::FromDigest(digests_ + i * DigestLen, DigestLen);
+}
+
+bool IDList::Contains(const ID &id) const {
+    const uint8_t *key = id.Digest().data();
+    size_t lo = 0;
+    size_t hi = count_;
+    if (fanout_) {
+        lo = key[0] == 0 ? 0 : static_cast<size_t>(loadLE(fanout_ + 8 * (key[0] - 1), 8));
+        hi = static_cast<size_t>(loadLE(fanout_ + 8 * key[0], 8));
+    }
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int c = std::memcmp(digests_ + mid * DigestLen, key, DigestLen);
+        if (c == 0)
+            return true;
+        if (c < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return false;
+}
+
+ID IDList::TreeID() const {
+    TreeBuilder builder;
+    const uint8_t *prev = nullptr;
+    for (size_t i = 0; i < count_; i++) {
+        const uint8_t *d = digests_ + i * DigestLen;
+        if (prev && std::memcmp(prev, d, DigestLen) >= 0)
+            throw std::runtime_error("invalid ID list: digests not strictly ascending");
+        builder.Add(ID::FromDigest(d, DigestLen));
+        prev = d;
+    }
+    return builder.Finalize();
+}
+
+} // namespace c4
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Apache-2.0
+// IDSet: open addressing over dense key storage
+//
+// The slot index comes from digest bytes 4..7 and the tag from bytes 0..3,
+// so the two are independent. Linear probing at a load factor of at most
+// 3/4; removal shifts the following cluster back instead of leaving
+// tombstones, so lookups never scan dead slots.
+
+#include "c4/idset.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define C4_IDSET_SSE2 1
+#include <emmintrin.h>
+#else
+#define C4_IDSET_SSE2 0
+#endif
+
+namespace c4 {
+
+namespace {
+
+constexpr size_t kMinSlots = 16;
+constexpr size_t kMaxSize = 0xFFFFFFFEu;  // positions are stored as uint32 + 1
+
+uint64_t hashOf(const ID &id) {
+    uint64_t h;
+    std::memcpy(&h, id.Digest().data(), sizeof(h));
+    return h;
+}
+
+uint32_t tagOf(uint64_t h) {
+    return static_cast<uint32_t>(h);
+}
+
+size_t homeOf(uint64_t h, size_t mask) {
+    return static_cast<size_t>(h >> 32) & mask;
+}
+
+bool sameDigest(const ID &a, const ID &b) {
+#if C4_IDSET_SSE2
+    const auto *pa = reinterpret_cast<const __m128i *>(a.Digest().data());
+    const auto *pb = reinterpret_cast<const __m128i *>(b.Digest().data());
+    __m128i eq = _mm_and_si128(
+        _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(pa), _mm_loadu_si128(pb)),
+                      _mm_cmpeq_epi8(_mm_loadu_si128(pa + 1), _mm_loadu_si128(pb + 1))),
+        _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(pa + 2), _mm_loadu_si128(pb + 2)),
+                      _mm_cmpeq_epi8(_mm_loadu_si128(pa + 3), _mm_loadu_si128(pb + 3))));
+    return _mm_movemask_epi8(eq) == 0xFFFF;
+#else
+    return a == b;
+#endif
+}
+
+// Smallest power-of-two slot count holding n keys at load <= 3/4.
+size_t slotsFor(size_t n) {
+    size_t slots = kMinSlots;
+    while (slots / 4 * 3 < n) {
+        slots *= 2;
+    }
+    return slots;
+}
+
+} // anonymous namespace
+
+bool IDSet::Insert(const ID &id) {
+    return insert(id).second;
+}
+
+bool IDSet::Contains(const ID &id) const {
+    return find(id) != npos;
+}
+
+bool IDSet::Remove(const ID &id) {
+    return remove(id) != npos;
+}
+
+void IDSet::Reserve(size_t n) {
+    keys_.reserve(n);
+    if (slotsFor(n) > slots_.size()) {
+        rehash(slotsFor(n));
+    }
+}
+
+void IDSet::Clear() {
+    keys_.clear();
+    slots_.clear();
+}
+
+size_t IDSet::find(const ID &id) const {
+    if (slots_.empty()) {
+        return npos;
+    }
+    const size_t mask = slots_.size() - 1;
+    const uint64_t h = hashOf(id);
+    const uint32_t tag = tagOf(h);
+    for (size_t i = homeOf(h, mask);; i = (i + 1) & mask) {
+        const Slot &s = slots_[i];
+        if (s.pos == 0) {
+            return npos;
+        }
+        if (s.tag == tag && sameDigest(keys_[s.pos - 1], id)) {
+            return s.pos - 1;
+        }
+    }
+}
+
+std::pair<size_t, bool> IDSet::insert(const ID &id) {
+    if (slots_.size() / 4 * 3 <= keys_.size()) {
+        if (keys_.size() >= kMaxSize) {
+            throw std::length_error("IDSet is full");
+        }
+        rehash(slotsFor(keys_.size() + 1));
+    }
+    const size_t mask = slots_.size() - 1;
+    const uint64_t h = hashOf(id);
+    const uint32_t tag = tagOf(h);
+    size_t i = homeOf(h, mask);
+    for (;; i = (i + 1) & mask) {
+        const Slot &s = slots_[i];
+        if (s.pos == 0) {
+            break;
+        }
+        if (s.tag == tag && sameDigest(keys_[s.pos - 1], id)) {
+            return {s.pos - 1, false};
+        }
+    }
+    keys_.push_back(id);
+    slots_[i] = {tag, static_cast<uint32_t>(keys_.size())};
+    return {keys_.size() - 1, true};
+}
+
+size_t IDSet::remove(const ID &id) {
+    if (slots_.empty()) {
+        return npos;
+    }
+    const size_t mask = slots_.size() - 1;
+    const uint64_t h = hashOf(id);
+    const uint32_t tag = tagOf(h);
+    size_t i = homeOf(h, mask);
+    for (;; i = (i + 1) & mask) {
+        const Slot &s = slots_[i];
+        if (s.pos == 0) {
+            return npos;
+        }
+        if (s.tag == tag && sameDigest(keys_[s.pos - 1], id)) {
+            break;
+        }
+    }
+    const size_t pos = slots_[i].pos - 1;
+
+    // Backward-shift: pull later members of the cluster into the hole
+    // unless that would move them before their home slot.
+    for (size_t j = (i + 1) & mask; slots_[j].pos != 0; j = (j + 1) & mask) {
+        size_t home = homeOf(hashOf(keys_[slots_[j].pos - 1]), mask);
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            slots_[i] = slots_[j];
+            i = j;
+        }
+    }
+    slots_[i].pos = 0;
+
+    // Keep keys_ dense: the last key takes the freed position.
+    const size_t last = keys_.size() - 1;
+    if (pos != last) {
+        keys_[pos] = keys_[last];
+        for (size_t j = homeOf(hashOf(keys_[pos]), mask);; j = (j + 1) & mask) {
+            if (slots_[j].pos == last + 1) {
+                slots_[j].pos = static_cast<uint32_t>(pos + 1);
+                break;
+            }
+        }
+    }
+    keys_.pop_back();
+    return pos;
+}
+
+void IDSet::rehash(size_t slots) {
+    slots_.assign(slots, Slot{0, 0});
+    const size_t mask = slots - 1;
+    for (size_t pos = 0; pos < keys_.size(); pos++) {
+        const uint64_t h = hashOf(keys_[pos]);
+        size_t i = homeOf(h, mask);
+        while (slots_[i].pos != 0) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = {tagOf(h), static_cast<uint32_t>(pos + 1)};
+    }
+}
+
+} // namespace c4
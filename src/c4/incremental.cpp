@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: Apache-2.0
+// Incremental tree ID maintenance (IncrementalIDs)
+//
+// Node j of level L+1 is Sum(level L nodes 2j, 2j+1). After a change, a
+// pair can reuse its cached node only if both inputs are unchanged and were
+// paired together before: they lie in one unchanged run whose position
+// shifted by an even amount. Every other pair is rehashed, in contiguous
+// batches through ID::SumAdjacent. The odd last node of a level is treated
+// as changed, which costs at most one extra Sum per level above it.
+//
+// Pairing is positional, so a run that shifted by an odd amount has no
+// reusable pairs at the next level. For changes scattered over the whole
+// set this bounds the saving at roughly half the hashing of a rebuild, on
+// top of skipping the copy and sort; changes clustered together, or
+// balanced inserts and removals, keep most of the tree.
+
+#include "c4/c4.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace c4 {
+
+IncrementalIDs::IncrementalIDs(const IDs &ids) {
+    std::vector<c4::ID> leaves(ids.begin(), ids.end());
+    if (!ids.SortedUnique()) {
+        std::sort(leaves.begin(), leaves.end());
+        leaves.erase(std::unique(leaves.begin(), leaves.end()), leaves.end());
+    }
+    rebuild(std::move(leaves), {});
+}
+
+void IncrementalIDs::Insert(const c4::ID &id) {
+    pending_[id] = true;
+}
+
+void IncrementalIDs::Remove(const c4::ID &id) {
+    pending_[id] = false;
+}
+
+c4::ID IncrementalIDs::TreeID() const {
+    apply();
+    if (levels_.empty() || levels_[0].empty()) {
+        return c4::ID();
+    }
+    return levels_.back()[0];
+}
+
+size_t IncrementalIDs::Size() const {
+    apply();
+    return levels_.empty() ? 0 : levels_[0].size();
+}
+
+bool IncrementalIDs::Contains(const c4::ID &id) const {
+    auto it = pending_.find(id);
+    if (it != pending_.end()) {
+        return it->second;
+    }
+    return !levels_.empty() && std::binary_search(levels_[0].begin(), levels_[0].end(), id);
+}
+
+InclusionProof IncrementalIDs::Proof(const c4::ID &id) const {
+    apply();
+    if (levels_.empty()) {
+        throw std::invalid_argument("ID is not in the set");
+    }
+    const auto &leaves = levels_[0];
+    auto it = std::lower_bound(leaves.begin(), leaves.end(), id);
+    if (it == leaves.end() || *it != id) {
+        throw std::invalid_argument("ID is not in the set");
+    }
+
+    InclusionProof proof;
+    proof.index = static_cast<uint64_t>(it - leaves.begin());
+    proof.count = leaves.size();
+    size_t index = proof.index;
+    for (size_t depth = 0; depth + 1 < levels_.size(); depth++, index /= 2) {
+        const auto &level = levels_[depth];
+        if ((index ^ 1) < level.size()) {
+            proof.siblings.push_back(level[index ^ 1]);
+        }
+    }
+    return proof;
+}
+
+// Merge the queued changes into the sorted leaves, recording which
+// stretches of the new leaf level are unchanged, then rebuild.
+void IncrementalIDs::apply() const {
+    if (pending_.empty()) {
+        return;
+    }
+    if (levels_.empty()) {
+        levels_.emplace_back();
+    }
+    const auto &old = levels_[0];
+
+    std::vector<c4::ID> leaves;
+    leaves.reserve(old.size() + pending_.size());
+    std::vector<Run> runs;
+    size_t i = 0;
+
+    // Copy old[i, stop) unchanged, extending the previous run if contiguous.
+    auto keep = [&](size_t stop) {
+        if (stop <= i) {
+            return;
+        }
+        size_t at = leaves.size();
+        if (!runs.empty() && runs.back().end == at &&
+            runs.back().old_begin + (at - runs.back().begin) == i) {
+            runs.back().end = at + (stop - i);
+        } else {
+            runs.push_back({at, at + (stop - i), i});
+        }
+        leaves.insert(leaves.end(), old.begin() + static_cast<ptrdiff_t>(i),
+                      old.begin() + static_cast<ptrdiff_t>(stop));
+        i = stop;
+    };
+
+    for (const auto &[id, insert] : pending_) {
+        auto pos = std::lower_bound(old.begin() + static_cast<ptrdiff_t>(i), old.end(), id);
+        keep(static_cast<size_t>(pos - old.begin()));
+        bool present = i < old.size() && old[i] == id;
+        if (insert && !present) {
+            leaves.push_back(id);
+        } else if (!insert && present) {
+            i++;
+        }
+    }
+    keep(old.size());
+    pending_.clear();
+
+    rebuild(std::move(leaves), std::move(runs));
+}
+
+// Recompute all levels above `level` (the new leaf level), reusing cached
+// nodes of the current levels_ wherever `runs` allows.
+void IncrementalIDs::rebuild(std::vector<c4::ID> level, std::vector<Run> runs) const {
+    std::vector<std::vector<c4::ID>> levels;
+
+    while (level.size() > 1) {
+        const size_t depth = levels.size();
+        const size_t m = level.size();
+        const size_t pairs = m / 2;
+        const std::vector<c4::ID> *old_next =
+            depth + 1 < levels_.size() ? &levels_[depth + 1] : nullptr;
+
+        std::vector<c4::ID> next((m + 1) / 2);
+        std::vector<Run> next_runs;
+        size_t done = 0;  // pairs [0, done) are filled in
+
+        auto hash = [&](size_t stop) {
+            if (stop > done) {
+                c4::ID::SumAdjacent(level.data() + 2 * done, 2 * (stop - done),
+                                    next.data() + done);
+                done = stop;
+            }
+        };
+
+        for (const auto &r : runs) {
+            // An odd shift pairs each node with a different neighbour.
+            if (!old_next || (r.begin + r.old_begin) % 2 != 0) {
+                continue;
+            }
+            size_t jb = (r.begin + 1) / 2;
+            size_t je = std::min(r.end / 2, pairs);
+            if (jb >= je) {
+                continue;
+            }
+            size_t kb = (r.old_begin + 2 * jb - r.begin) / 2;
+            hash(jb);
+            std::copy_n(old_next->begin() + static_cast<ptrdiff_t>(kb), je - jb,
+                        next.begin() + static_cast<ptrdiff_t>(jb));
+            next_runs.push_back({jb, je, kb});
+            done = je;
+        }
+        hash(pairs);
+
+        // Odd element passes through
+        if (m % 2) {
+            next[pairs] = level[m - 1];
+        }
+
+        levels.push_back(std::move(level));
+        level = std::move(next);
+        runs = std::move(next_runs);
+    }
+
+    levels.push_back(std::move(level));
+    levels_ = std::move(levels);
+}
+
+} // namespace c4
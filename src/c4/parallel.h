@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: Apache-2.0
+// Minimal fork-join helper shared by the multi-threaded code paths.
+#ifndef C4_PARALLEL_H
+#define C4_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace c4::detail {
+
+// Resolve a requested thread count (0 = hardware concurrency) against the
+// number of independent work items.
+inline unsigned WorkerCount(unsigned requested, size_t work_items) {
+    unsigned n = requested ? requested : std::thread::hardware_concurrency();
+    if (n == 0)
+        n = 1;
+    if (work_items < n)
+        n = static_cast<unsigned>(std::max<size_t>(work_items, 1));
+    return n;
+}
+
+// Call fn(begin, end) over [0, n) in blocks of `grain` items, on up to
+// `threads` threads including the caller. Blocks are handed out through an
+// atomic counter, so neighbouring items tend to land on the same thread.
+// If fn throws, remaining blocks are skipped and the exception is rethrown
+// on the calling thread once all workers have stopped.
+template <class Fn>
+void ParallelFor(size_t n, unsigned threads, size_t grain, Fn &&fn) {
+    if (n == 0)
+        return;
+    grain = std::max<size_t>(grain, 1);
+    size_t nblocks = (n + grain - 1) / grain;
+    unsigned workers = WorkerCount(threads, nblocks);
+    if (workers == 1) {
+        fn(size_t{0}, n);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex error_mu;
+
+    auto work = [&] {
+        while (!failed.load(std::memory_order_relaxed)) {
+            size_t b = next.fetch_add(1, std::memory_order_relaxed);
+            if (b >= nblocks)
+                return;
+            try {
+                fn(b * grain, std::min(n, (b + 1) * grain));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mu);
+                if (!error)
+                    error = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (unsigned i = 1; i < workers; i++)
+        pool.emplace_back(work);
+    work();
+    for (auto &t : pool)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace c4::detail
+
+#endif // C4_PARALLEL_H
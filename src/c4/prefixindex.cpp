@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+// PrefixIndex: abbreviated-ID lookup over sorted digests
+
+#include "c4/prefixindex.hpp"
+#include "base58.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace c4 {
+
+namespace {
+
+// Digest of "c4" + digits padded to full width with pad. Returns the
+// validation result: Overflow if the padded value exceeds 2^512 - 1.
+base58::Check boundDigest(std::string_view digits, char pad,
+                          std::array<uint8_t, DigestLen> &out) {
+    char text[IDLen];
+    text[0] = 'c';
+    text[1] = '4';
+    std::memcpy(text + 2, digits.data(), digits.size());
+    std::memset(text + 2 + digits.size(), pad, base58::DigitsLen - digits.size());
+    auto check = base58::Validate(text, IDLen);
+    if (check == base58::Check::Ok) {
+        base58::Decode(text + 2, out.data());
+    }
+    return check;
+}
+
+} // anonymous namespace
+
+PrefixIndex::PrefixIndex(IDs ids) : ids_(std::move(ids)) {
+    ids_.SortUnique();
+}
+
+PrefixResult PrefixIndex::Resolve(std::string_view prefix) const {
+    PrefixResult result;
+    if (prefix.size() < 2 || prefix.size() > IDLen || prefix[0] != 'c' || prefix[1] != '4') {
+        result.match = PrefixMatch::Invalid;
+        return result;
+    }
+    const auto digits = prefix.substr(2);
+
+    std::array<uint8_t, DigestLen> lo{};
+    std::array<uint8_t, DigestLen> hi{};
+    switch (boundDigest(digits, '1', lo)) {
+    case base58::Check::Ok:
+        break;
+    case base58::Check::Overflow:
+        return result;  // every ID with this prefix would exceed 2^512 - 1
+    default:
+        result.match = PrefixMatch::Invalid;
+        return result;
+    }
+    if (boundDigest(digits, 'z', hi) != base58::Check::Ok) {
+        hi.fill(0xFF);  // the range runs past the largest digest
+    }
+
+    const ID lo_id(lo);
+    const ID hi_id(hi);
+    auto first = std::lower_bound(ids_.begin(), ids_.end(), lo_id);
+    // Typed prefixes usually match one or two IDs: step over those before
+    // falling back to a second binary search.
+    auto last = first;
+    for (int i = 0; i < 4 && last != ids_.end() && !(hi_id < *last); i++) {
+        ++last;
+    }
+    if (last != ids_.end() && !(hi_id < *last)) {
+        last = std::upper_bound(last, ids_.end(), hi_id);
+    }
+    result.count = static_cast<size_t>(last - first);
+    if (result.count > 0) {
+        result.id = *first;
+    }
+    result.match = result.count == 0   ? PrefixMatch::None
+                   : result.count == 1 ? PrefixMatch::Unique
+                                       : PrefixMatch::Ambiguous;
+    return result;
+}
+
+} // namespace c4
@@ -0,0 +1,515 @@
+// SPDX-License-Identifier: Apache-2.0
+// SHA-512 (FIPS 180-4): portable scalar compression plus multi-lane AVX2 and
+// AVX-512 kernels that hash 4 or 8 independent messages at once.
+//
+// The multi-lane kernels keep one message per 64-bit lane. Messages in a
+// group are fed block by block; a lane whose message has already finished
+// hashes a zero block whose result is discarded. DigestMany orders messages
+// by padded block count so lanes in a group finish together.
+
+#include "sha512.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define C4_SHA512_X86 1
+#include <immintrin.h>
+#else
+#define C4_SHA512_X86 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define C4_SHA512_INLINE inline __attribute__((always_inline))
+#else
+#define C4_SHA512_INLINE inline
+#endif
+
+namespace {
+
+using c4::sha512::BlockLen;
+using c4::sha512::DigestLen;
+
+constexpr uint64_t K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+constexpr uint64_t IV[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL,
+};
+
+constexpr uint64_t rotr(uint64_t x, int n) {
+    return (x >> n) | (x << (64 - n));
+}
+
+// Message schedule, with K[t] folded in, of the block that follows an
+// exactly-128-byte message: 0x80 marker, zero fill, bit length 1024. It is
+// the same for every such message, so ID::Sum never computes it at runtime.
+constexpr std::array<uint64_t, 80> kPad128WK = [] {
+    std::array<uint64_t, 80> w{};
+    w[0] = 0x8000000000000000ULL;
+    w[15] = 1024;
+    for (int t = 16; t < 80; t++) {
+        uint64_t s0 = rotr(w[t - 15], 1) ^ rotr(w[t - 15], 8) ^ (w[t - 15] >> 7);
+        uint64_t s1 = rotr(w[t - 2], 19) ^ rotr(w[t - 2], 61) ^ (w[t - 2] >> 6);
+        w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+    }
+    for (int t = 0; t < 80; t++)
+        w[t] += K[t];
+    return w;
+}();
+
+inline uint64_t load64be(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+inline void store64be(uint8_t *p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = static_cast<uint8_t>(v);
+        v >>= 8;
+    }
+}
+
+#define C4_SHA512_ROUND(wk)                                                   \
+    do {                                                                      \
+        uint64_t t1 = hh + (rotr(e, 14) ^ rotr(e, 18) ^ rotr(e, 41)) +        \
+                      ((e & f) ^ (~e & g)) + (wk);                            \
+        uint64_t t2 = (rotr(a, 28) ^ rotr(a, 34) ^ rotr(a, 39)) +             \
+                      ((a & b) ^ (a & c) ^ (b & c));                          \
+        hh = g; g = f; f = e; e = d + t1;                                     \
+        d = c; c = b; b = a; a = t1 + t2;                                     \
+    } while (0)
+
+// Compress one block given its 16 big-endian message words.
+C4_SHA512_INLINE void compressWords(uint64_t h[8], uint64_t w[16]) {
+    uint64_t a = h[0], b = h[1], c = h[2], d = h[3];
+    uint64_t e = h[4], f = h[5], g = h[6], hh = h[7];
+
+    for (int t = 0; t < 80; t++) {
+        if (t >= 16) {
+            uint64_t w15 = w[(t - 15) & 15];
+            uint64_t w2 = w[(t - 2) & 15];
+            uint64_t s0 = rotr(w15, 1) ^ rotr(w15, 8) ^ (w15 >> 7);
+            uint64_t s1 = rotr(w2, 19) ^ rotr(w2, 61) ^ (w2 >> 6);
+            w[t & 15] += s0 + w[(t - 7) & 15] + s1;
+        }
+        C4_SHA512_ROUND(K[t] + w[t & 15]);
+    }
+
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+    h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+}
+
+void compress(uint64_t h[8], const uint8_t *block) {
+    uint64_t w[16];
+    for (int t = 0; t < 16; t++)
+        w[t] = load64be(block + 8 * t);
+    compressWords(h, w);
+}
+
+// Compress the constant padding block of a 128-byte message.
+C4_SHA512_INLINE void compressPad128(uint64_t h[8]) {
+    uint64_t a = h[0], b = h[1], c = h[2], d = h[3];
+    uint64_t e = h[4], f = h[5], g = h[6], hh = h[7];
+    for (int t = 0; t < 80; t++)
+        C4_SHA512_ROUND(kPad128WK[t]);
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+    h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+}
+
+#undef C4_SHA512_ROUND
+
+// A message viewed as its padded block sequence. Complete data blocks are
+// read in place; the final one or two blocks (remaining bytes, 0x80 marker,
+// zero fill, 128-bit big-endian bit length) are assembled in tail.
+struct PaddedMessage {
+    const uint8_t *data = nullptr;
+    size_t full = 0;
+    size_t nblocks = 0;
+    uint8_t tail[2 * BlockLen];
+
+    void Init(const uint8_t *d, size_t len) {
+        data = d;
+        full = len / BlockLen;
+        nblocks = c4::sha512::BlockCount(len);
+        size_t rem = len - full * BlockLen;
+        size_t tail_len = (nblocks - full) * BlockLen;
+        std::memset(tail, 0, tail_len);
+        if (rem > 0)
+            std::memcpy(tail, d + full * BlockLen, rem);
+        tail[rem] = 0x80;
+        // Bit length: the high 64 bits are zero for any size_t length.
+        store64be(tail + tail_len - 8, static_cast<uint64_t>(len) << 3);
+        store64be(tail + tail_len - 16, static_cast<uint64_t>(len) >> 61);
+    }
+
+    const uint8_t *Block(size_t i) const {
+        return i < full ? data + i * BlockLen : tail + (i - full) * BlockLen;
+    }
+};
+
+void finish(const uint64_t h[8], uint8_t *out) {
+    for (int i = 0; i < 8; i++)
+        store64be(out + 8 * i, h[i]);
+}
+
+#if C4_SHA512_X86
+
+// Zero block fed to lanes whose message has already finished.
+alignas(64) const uint8_t kZeroBlock[BlockLen] = {};
+
+// Padding block of an exactly-128-byte message, for the multi-lane pair path.
+alignas(64) constexpr std::array<uint8_t, BlockLen> kPad128Block = [] {
+    std::array<uint8_t, BlockLen> b{};
+    b[0] = 0x80;
+    b[BlockLen - 2] = 0x04;  // 1024 bits, big-endian
+    return b;
+}();
+
+// Transpose the 16 big-endian message words of each lane's block into
+// word-major order so each row loads as one vector.
+template <size_t L>
+inline void loadSchedule(uint64_t (*w)[L], const uint8_t *const *blocks) {
+    for (size_t l = 0; l < L; l++) {
+        const uint8_t *p = blocks[l];
+        for (int t = 0; t < 16; t++)
+            w[t][l] = load64be(p + 8 * t);
+    }
+}
+
+__attribute__((target("avx2")))
+inline __m256i rotr4(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n));
+}
+
+__attribute__((target("avx2")))
+void compressX4(uint64_t (*state)[4], const uint8_t *const *blocks) {
+    alignas(32) uint64_t wbuf[16][4];
+    loadSchedule<4>(wbuf, blocks);
+
+    __m256i w[16];
+    for (int t = 0; t < 16; t++)
+        w[t] = _mm256_load_si256(reinterpret_cast<const __m256i *>(wbuf[t]));
+
+    __m256i s[8];
+    for (int i = 0; i < 8; i++)
+        s[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[i]));
+    __m256i a = s[0], b = s[1], c = s[2], d = s[3];
+    __m256i e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (int t = 0; t < 80; t++) {
+        if (t >= 16) {
+            __m256i w15 = w[(t - 15) & 15];
+            __m256i w2 = w[(t - 2) & 15];
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr4(w15, 1), rotr4(w15, 8)),
+                                          _mm256_srli_epi64(w15, 7));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr4(w2, 19), rotr4(w2, 61)),
+                                          _mm256_srli_epi64(w2, 6));
+            w[t & 15] = _mm256_add_epi64(_mm256_add_epi64(w[t & 15], s0),
+                                         _mm256_add_epi64(w[(t - 7) & 15], s1));
+        }
+        __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(rotr4(e, 14), rotr4(e, 18)), rotr4(e, 41));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = _mm256_add_epi64(
+            _mm256_add_epi64(_mm256_add_epi64(h, S1), _mm256_add_epi64(ch, w[t & 15])),
+            _mm256_set1_epi64x(static_cast<long long>(K[t])));
+        __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(rotr4(a, 28), rotr4(a, 34)), rotr4(a, 39));
+        __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b),
+                                      _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        __m256i t2 = _mm256_add_epi64(S0, maj);
+        h = g; g = f; f = e; e = _mm256_add_epi64(d, t1);
+        d = c; c = b; b = a; a = _mm256_add_epi64(t1, t2);
+    }
+
+    __m256i r[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 8; i++)
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[i]), _mm256_add_epi64(s[i], r[i]));
+}
+
+// Rotate and shift through the zero-masking forms with a full mask. The
+// plain _mm512_ror_epi64/_mm512_srli_epi64 in GCC 12's avx512fintrin.h
+// pass _mm512_undefined_epi32() as the merge source, which trips
+// -Wuninitialized once inlined; the generated code is the same.
+template <int N>
+__attribute__((target("avx512f")))
+inline __m512i rotr8(__m512i x) {
+    return _mm512_maskz_ror_epi64(static_cast<__mmask8>(0xFF), x, N);
+}
+
+template <int N>
+__attribute__((target("avx512f")))
+inline __m512i shr8(__m512i x) {
+    return _mm512_maskz_srli_epi64(static_cast<__mmask8>(0xFF), x, N);
+}
+
+__attribute__((target("avx512f")))
+void compressX8(uint64_t (*state)[8], const uint8_t *const *blocks) {
+    alignas(64) uint64_t wbuf[16][8];
+    loadSchedule<8>(wbuf, blocks);
+
+    __m512i w[16];
+    for (int t = 0; t < 16; t++)
+        w[t] = _mm512_load_si512(wbuf[t]);
+
+    __m512i s[8];
+    for (int i = 0; i < 8; i++)
+        s[i] = _mm512_loadu_si512(state[i]);
+    __m512i a = s[0], b = s[1], c = s[2], d = s[3];
+    __m512i e = s[4], f = s[5], g = s[6], h = s[7];
+
+    // ternarylogic immediates: 0x96 = x^y^z, 0xCA = x?y:z (Ch), 0xE8 = majority
+    for (int t = 0; t < 80; t++) {
+        if (t >= 16) {
+            __m512i w15 = w[(t - 15) & 15];
+            __m512i w2 = w[(t - 2) & 15];
+            __m512i s0 = _mm512_ternarylogic_epi64(rotr8<1>(w15), rotr8<8>(w15),
+                                                   shr8<7>(w15), 0x96);
+            __m512i s1 = _mm512_ternarylogic_epi64(rotr8<19>(w2), rotr8<61>(w2),
+                                                   shr8<6>(w2), 0x96);
+            w[t & 15] = _mm512_add_epi64(_mm512_add_epi64(w[t & 15], s0),
+                                         _mm512_add_epi64(w[(t - 7) & 15], s1));
+        }
+        __m512i S1 = _mm512_ternarylogic_epi64(rotr8<14>(e), rotr8<18>(e),
+                                               rotr8<41>(e), 0x96);
+        __m512i ch = _mm512_ternarylogic_epi64(e, f, g, 0xCA);
+        __m512i t1 = _mm512_add_epi64(
+            _mm512_add_epi64(_mm512_add_epi64(h, S1), _mm512_add_epi64(ch, w[t & 15])),
+            _mm512_set1_epi64(static_cast<long long>(K[t])));
+        __m512i S0 = _mm512_ternarylogic_epi64(rotr8<28>(a), rotr8<34>(a),
+                                               rotr8<39>(a), 0x96);
+        __m512i maj = _mm512_ternarylogic_epi64(a, b, c, 0xE8);
+        __m512i t2 = _mm512_add_epi64(S0, maj);
+        h = g; g = f; f = e; e = _mm512_add_epi64(d, t1);
+        d = c; c = b; b = a; a = _mm512_add_epi64(t1, t2);
+    }
+
+    __m512i r[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 8; i++)
+        _mm512_storeu_si512(state[i], _mm512_add_epi64(s[i], r[i]));
+}
+
+// Hash up to L messages through an L-lane kernel. Unused lanes hash the
+// zero block and are never read back.
+template <size_t L, void (*Kernel)(uint64_t (*)[L], const uint8_t *const *)>
+void digestGroup(const PaddedMessage *const *msgs, size_t n, uint8_t *const *out) {
+    uint64_t state[8][L];
+    for (int i = 0; i < 8; i++)
+        for (size_t l = 0; l < L; l++)
+            state[i][l] = IV[i];
+
+    size_t max_blocks = 0;
+    for (size_t l = 0; l < n; l++)
+        max_blocks = std::max(max_blocks, msgs[l]->nblocks);
+
+    const uint8_t *blocks[L];
+    for (size_t blk = 0; blk < max_blocks; blk++) {
+        for (size_t l = 0; l < L; l++) {
+            blocks[l] = (l < n && blk < msgs[l]->nblocks) ? msgs[l]->Block(blk) : kZeroBlock;
+        }
+        Kernel(state, blocks);
+        for (size_t l = 0; l < n; l++) {
+            if (msgs[l]->nblocks == blk + 1) {
+                uint64_t h[8];
+                for (int i = 0; i < 8; i++)
+                    h[i] = state[i][l];
+                finish(h, out[l]);
+            }
+        }
+    }
+}
+
+// Hash up to L 128-byte messages first[l] || second[l] through an L-lane
+// kernel: one data block gathered per lane, then the shared padding block.
+template <size_t L, void (*Kernel)(uint64_t (*)[L], const uint8_t *const *)>
+void digestPairGroup(const uint8_t *const *first, const uint8_t *const *second, size_t n,
+                     uint8_t *const *out) {
+    uint64_t state[8][L];
+    for (int i = 0; i < 8; i++)
+        for (size_t l = 0; l < L; l++)
+            state[i][l] = IV[i];
+
+    alignas(64) uint8_t buf[L][BlockLen];
+    const uint8_t *blocks[L];
+    for (size_t l = 0; l < L; l++) {
+        if (l < n) {
+            std::memcpy(buf[l], first[l], DigestLen);
+            std::memcpy(buf[l] + DigestLen, second[l], DigestLen);
+            blocks[l] = buf[l];
+        } else {
+            blocks[l] = kZeroBlock;
+        }
+    }
+    Kernel(state, blocks);
+    for (size_t l = 0; l < L; l++)
+        blocks[l] = kPad128Block.data();
+    Kernel(state, blocks);
+
+    for (size_t l = 0; l < n; l++) {
+        uint64_t h[8];
+        for (int i = 0; i < 8; i++)
+            h[i] = state[i][l];
+        finish(h, out[l]);
+    }
+}
+
+#endif // C4_SHA512_X86
+
+size_t detectLanes() {
+#if C4_SHA512_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return 8;
+    if (__builtin_cpu_supports("avx2"))
+        return 4;
+#endif
+    return 1;
+}
+
+C4_SHA512_INLINE void digestPairImpl(const uint8_t *first, const uint8_t *second,
+                                     uint8_t *out) {
+    uint64_t w[16];
+    for (int t = 0; t < 8; t++) {
+        w[t] = load64be(first + 8 * t);
+        w[t + 8] = load64be(second + 8 * t);
+    }
+    uint64_t h[8];
+    std::memcpy(h, IV, sizeof(h));
+    compressWords(h, w);
+    compressPad128(h);
+    finish(h, out);
+}
+
+using DigestPairFn = void (*)(const uint8_t *, const uint8_t *, uint8_t *);
+
+void digestPairPortable(const uint8_t *first, const uint8_t *second, uint8_t *out) {
+    digestPairImpl(first, second, out);
+}
+
+#if C4_SHA512_X86
+// Same code built with BMI2, whose three-operand rotate (rorx) removes most
+// of the register moves in the sigma functions.
+__attribute__((target("bmi2")))
+void digestPairBmi2(const uint8_t *first, const uint8_t *second, uint8_t *out) {
+    digestPairImpl(first, second, out);
+}
+#endif
+
+DigestPairFn detectDigestPair() {
+#if C4_SHA512_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("bmi2"))
+        return digestPairBmi2;
+#endif
+    return digestPairPortable;
+}
+
+} // anonymous namespace
+
+namespace c4::sha512 {
+
+void Digest(const void *data, size_t len, uint8_t out[DigestLen]) {
+    PaddedMessage msg;
+    msg.Init(static_cast<const uint8_t *>(data), len);
+    uint64_t h[8];
+    std::memcpy(h, IV, sizeof(h));
+    for (size_t i = 0; i < msg.nblocks; i++)
+        compress(h, msg.Block(i));
+    finish(h, out);
+}
+
+void DigestPair(const uint8_t first[DigestLen], const uint8_t second[DigestLen],
+                uint8_t out[DigestLen]) {
+    static const DigestPairFn fn = detectDigestPair();
+    fn(first, second, out);
+}
+
+size_t Lanes() {
+    static const size_t lanes = detectLanes();
+    return lanes;
+}
+
+void DigestPairs(const uint8_t *const *first, const uint8_t *const *second, size_t count,
+                 uint8_t *const *out) {
+    size_t lanes = Lanes();
+    size_t i = 0;
+#if C4_SHA512_X86
+    if (lanes > 1) {
+        for (; i + 1 < count; i += lanes) {
+            size_t n = std::min(lanes, count - i);
+            if (lanes == 8) {
+                digestPairGroup<8, compressX8>(first + i, second + i, n, out + i);
+            } else {
+                digestPairGroup<4, compressX4>(first + i, second + i, n, out + i);
+            }
+        }
+    }
+#endif
+    for (; i < count; i++)
+        DigestPair(first[i], second[i], out[i]);
+}
+
+void DigestMany(const uint8_t *const *data, const size_t *lens, size_t count,
+                uint8_t *const *out) {
+    size_t lanes = Lanes();
+    if (lanes == 1 || count < 2) {
+        for (size_t i = 0; i < count; i++)
+            Digest(data[i], lens[i], out[i]);
+        return;
+    }
+
+#if C4_SHA512_X86
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) {
+        return BlockCount(lens[x]) < BlockCount(lens[y]);
+    });
+
+    PaddedMessage msgs[8];
+    const PaddedMessage *group[8];
+    uint8_t *group_out[8];
+    for (size_t base = 0; base < count; base += lanes) {
+        size_t n = std::min(lanes, count - base);
+        for (size_t l = 0; l < n; l++) {
+            size_t idx = order[base + l];
+            msgs[l].Init(data[idx], lens[idx]);
+            group[l] = &msgs[l];
+            group_out[l] = out[idx];
+        }
+        if (n == 1) {
+            Digest(data[order[base]], lens[order[base]], group_out[0]);
+        } else if (lanes == 8) {
+            digestGroup<8, compressX8>(group, n, group_out);
+        } else {
+            digestGroup<4, compressX4>(group, n, group_out);
+        }
+    }
+#endif
+}
+
+} // namespace c4::sha512
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+// In-tree SHA-512 used by the small-message hot paths (batch identification,
+// ID::Sum).
+//
+// Large and streaming inputs still go through OpenSSL EVP, whose assembly
+// is the fastest single-stream implementation available. This code targets
+// the opposite case: many short, independent messages, where the per-call
+// EVP overhead dominates and several messages can share one SIMD register.
+#ifndef C4_SHA512_H
+#define C4_SHA512_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace c4::sha512 {
+
+constexpr size_t BlockLen = 128;
+constexpr size_t DigestLen = 64;
+
+// Number of padded blocks for a message of len bytes (0x80 marker and
+// 128-bit length included).
+constexpr size_t BlockCount(size_t len) {
+    return (len + 1 + 16 + BlockLen - 1) / BlockLen;
+}
+
+// Portable one-shot digest.
+void Digest(const void *data, size_t len, uint8_t out[DigestLen]);
+
+// Digest of the 128-byte message first || second, as used by ID::Sum.
+// Costs exactly two compressions; the padding block's message schedule is
+// a compile-time constant.
+void DigestPair(const uint8_t first[DigestLen], const uint8_t second[DigestLen],
+                uint8_t out[DigestLen]);
+
+// DigestPair over count independent pairs, several at a time in SIMD lanes
+// when the CPU allows. out[i] may alias first[i] or second[i].
+void DigestPairs(const uint8_t *const *first, const uint8_t *const *second, size_t count,
+                 uint8_t *const *out);
+
+// Digest count independent messages. Uses the widest multi-lane kernel the
+// CPU supports (AVX-512: 8 lanes, AVX2: 4 lanes) and the portable scalar
+// code otherwise. out[i] receives the digest of data[i][0..lens[i]).
+void DigestMany(const uint8_t *const *data, const size_t *lens, size_t count,
+                uint8_t *const *out);
+
+// Lane width DigestMany will use on this CPU (1 = scalar).
+size_t Lanes();
+
+} // namespace c4::sha512
+
+#endif // C4_SHA512_H
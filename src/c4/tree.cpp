@@ -6,11 +6,27 @@
 // smaller||larger). Odd elements pass through to the next level. This
 // matches the Go reference implementation.
 //
-// This implementation reuses two pre-allocated vectors, swapping between
-// them at each level to avoid per-level allocation.
+// The first level is read straight from the sorted leaves, so a set that
+// is already sorted and unique is never copied; the levels above swap
+// between two buffers, one of which can be the leaves' own storage when
+// the set is consumed. The pairs of a level are independent, so each level
+// is hashed as one batch (ID::SumAdjacent), several pairs at a time in
+// SIMD lanes.
+//
+// ParallelTreeID produces the same result on a worker pool: digests are
+// uniformly distributed, so an MSD bucket pass on the first digest byte
+// splits the sort into 256 independent, similar-sized pieces; each level's
+// pairs are then hashed in parallel blocks.
+//
+// TreeBuilder streams sorted IDs through the same pairing. A node waits at
+// its level until its right neighbour arrives; the pair's Sum moves up one
+// level. At the end, the unpaired nodes left on each level are exactly the
+// odd elements the level-by-level loop passes through, so folding them
+// bottom-up (lower-level node last) reproduces that result.
 
 #include "c4/c4.hpp"
 #include "internal.h"
+#include "parallel.h"
 
 #include <algorithm>
 #include <cstring>
@@ -19,48 +35,303 @@
 
 namespace c4 {
 
+namespace {
+
+// Pairs hashed per block in each level of a parallel tree computation.
+constexpr size_t kPairGrain = 2048;
+
+} // anonymous namespace
+
 void IDs::Append(const class ID &id) {
+    sorted_ = sorted_ && (ids_.empty() || ids_.back() < id);
     ids_.push_back(id);
 }
 
 void IDs::Append(class ID &&id) {
+    sorted_ = sorted_ && (ids_.empty() || ids_.back() < id);
     ids_.push_back(std::move(id));
 }
 
-c4::ID IDs::TreeID() const {
-    if (ids_.empty()) {
-        return c4::ID();
+void IDs::Reserve(size_t n) {
+    ids_.reserve(n);
+}
+
+void IDs::SortUnique() {
+    if (!sorted_) {
+        std::sort(ids_.begin(), ids_.end());
+        ids_.erase(std::unique(ids_.begin(), ids_.end()), ids_.end());
+        sorted_ = true;
+    }
+}
+
+c4::ID IDs::TreeID() const & {
+    Storage spare;
+    if (sorted_) {
+        return reduce(ids_.data(), ids_.size(), spare, 1);
     }
 
-    // Sort a copy and remove duplicates
-    auto current = ids_;
-    std::sort(current.begin(), current.end());
-    current.erase(std::unique(current.begin(), current.end()), current.end());
+    // Sort a copy and remove duplicates; the copy then becomes scratch.
+    spare = ids_;
+    std::sort(spare.begin(), spare.end());
+    spare.erase(std::unique(spare.begin(), spare.end()), spare.end());
+    return reduce(spare.data(), spare.size(), spare, 1);
+}
 
-    if (current.size() == 1) {
-        return current[0];
+c4::ID IDs::TreeID() && {
+    SortUnique();
+    Storage leaves = std::move(ids_);
+    ids_.clear();
+    return reduce(leaves.data(), leaves.size(), leaves, 1);
+}
+
+// Build the merkle tree bottom-up. The first level reads the leaves where
+// they are; the levels above swap roles between two buffers.
+c4::ID IDs::reduce(const c4::ID *leaves, size_t n, Storage &spare, unsigned workers) {
+    if (n == 0) {
+        return c4::ID();
+    }
+    if (n == 1) {
+        return leaves[0];
     }
 
-    // Build merkle tree bottom-up using two vectors, swapping roles each level
-    std::vector<c4::ID> next;
-    next.reserve((current.size() + 1) / 2);
+    // One level; each block of pairs is an independent SumAdjacent call.
+    auto level = [workers](const c4::ID *in, size_t count, c4::ID *out) {
+        if (workers <= 1) {
+            c4::ID::SumAdjacent(in, count, out);
+            return;
+        }
+        detail::ParallelFor((count + 1) / 2, workers, kPairGrain, [&](size_t begin, size_t end) {
+            size_t in_end = std::min(count, 2 * end);
+            c4::ID::SumAdjacent(in + 2 * begin, in_end - 2 * begin, out + begin);
+        });
+    };
 
+    Storage current((n + 1) / 2);
+    level(leaves, n, current.data());
     while (current.size() > 1) {
-        next.clear();
+        // Odd element passes through
+        spare.resize((current.size() + 1) / 2);
+        level(current.data(), current.size(), spare.data());
+        std::swap(current, spare);
+    }
+    return current[0];
+}
+
+InclusionProof IDs::Proof(const c4::ID &id) const {
+    // The first level reads the leaves where they are; an unsorted set is
+    // sorted into a copy, which then becomes scratch for the levels above.
+    Storage current;
+    const c4::ID *level = ids_.data();
+    size_t count = ids_.size();
+    if (!sorted_) {
+        current = ids_;
+        std::sort(current.begin(), current.end());
+        current.erase(std::unique(current.begin(), current.end()), current.end());
+        level = current.data();
+        count = current.size();
+    }
+
+    const c4::ID *it = std::lower_bound(level, level + count, id);
+    if (it == level + count || *it != id) {
+        throw std::invalid_argument("ID is not in the set");
+    }
 
-        size_t i = 0;
-        for (; i + 1 < current.size(); i += 2) {
-            next.push_back(current[i].Sum(current[i + 1]));
+    InclusionProof proof;
+    proof.index = static_cast<uint64_t>(it - level);
+    proof.count = count;
+
+    // Walk up the levels, taking the path node's sibling before each
+    // level is hashed. A missing sibling means the node passes through.
+    size_t index = proof.index;
+    Storage next;
+    while (count > 1) {
+        if ((index ^ 1) < count) {
+            proof.siblings.push_back(level[index ^ 1]);
         }
-        // Odd element passes through
-        if (i < current.size()) {
-            next.push_back(current[i]);
+        next.resize((count + 1) / 2);
+        c4::ID::SumAdjacent(level, count, next.data());
+        std::swap(current, next);
+        level = current.data();
+        count = current.size();
+        index /= 2;
+    }
+    return proof;
+}
+
+bool VerifyInclusion(const c4::ID &id, const InclusionProof &proof, const c4::ID &tree_id) {
+    if (proof.index >= proof.count) {
+        return false;
+    }
+    c4::ID node = id;
+    uint64_t index = proof.index;
+    size_t used = 0;
+    for (uint64_t m = proof.count; m > 1; m = (m + 1) / 2, index /= 2) {
+        if ((index ^ 1) >= m) {
+            continue;  // odd last element passes through
+        }
+        if (used == proof.siblings.size()) {
+            return false;
         }
+        node = node.Sum(proof.siblings[used++]);
+    }
+    return used == proof.siblings.size() && node == tree_id;
+}
 
-        std::swap(current, next);
+c4::ID IDs::ParallelTreeID(unsigned threads) const {
+    // Below this, thread start-up costs more than the work it spreads.
+    constexpr size_t kMinParallel = 4096;
+    constexpr size_t kBuckets = 256;
+
+    const size_t n = ids_.size();
+    unsigned workers = detail::WorkerCount(threads, n / kMinParallel);
+    if (n < kMinParallel || workers == 1) {
+        return TreeID();
+    }
+    if (sorted_) {
+        Storage spare;
+        return reduce(ids_.data(), n, spare, workers);
     }
 
-    return current[0];
+    // Bucket by first digest byte: per-slice histograms, then each slice
+    // scatters into its own precomputed range of every bucket.
+    const size_t slice = (n + workers - 1) / workers;
+    std::vector<std::array<size_t, kBuckets>> counts(workers);
+    detail::ParallelFor(workers, workers, 1, [&](size_t begin, size_t end) {
+        for (size_t w = begin; w < end; w++) {
+            auto &c = counts[w];
+            c.fill(0);
+            size_t last = std::min(n, (w + 1) * slice);
+            for (size_t i = w * slice; i < last; i++)
+                c[ids_[i].digest_[0]]++;
+        }
+    });
+
+    std::array<size_t, kBuckets + 1> bucket_start{};
+    size_t offset = 0;
+    for (size_t b = 0; b < kBuckets; b++) {
+        bucket_start[b] = offset;
+        for (unsigned w = 0; w < workers; w++) {
+            size_t c = counts[w][b];
+            counts[w][b] = offset;
+            offset += c;
+        }
+    }
+    bucket_start[kBuckets] = n;
+
+    Storage buckets(n);
+    detail::ParallelFor(workers, workers, 1, [&](size_t begin, size_t end) {
+        for (size_t w = begin; w < end; w++) {
+            auto &pos = counts[w];
+            size_t last = std::min(n, (w + 1) * slice);
+            for (size_t i = w * slice; i < last; i++)
+                buckets[pos[ids_[i].digest_[0]]++] = ids_[i];
+        }
+    });
+
+    // Sort and deduplicate each bucket, then compact the buckets.
+    std::array<size_t, kBuckets + 1> unique_start{};
+    std::array<size_t, kBuckets> unique_count{};
+    detail::ParallelFor(kBuckets, workers, 1, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            auto first = buckets.begin() + static_cast<ptrdiff_t>(bucket_start[b]);
+            auto last = buckets.begin() + static_cast<ptrdiff_t>(bucket_start[b + 1]);
+            std::sort(first, last);
+            unique_count[b] = static_cast<size_t>(std::unique(first, last) - first);
+        }
+    });
+    for (size_t b = 0; b < kBuckets; b++)
+        unique_start[b + 1] = unique_start[b] + unique_count[b];
+
+    Storage current(unique_start[kBuckets]);
+    detail::ParallelFor(kBuckets, workers, 1, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            std::copy_n(buckets.begin() + static_cast<ptrdiff_t>(bucket_start[b]),
+                        unique_count[b],
+                        current.begin() + static_cast<ptrdiff_t>(unique_start[b]));
+        }
+    });
+    buckets.clear();
+    buckets.shrink_to_fit();
+
+    return reduce(current.data(), current.size(), current, workers);
+}
+
+namespace {
+
+// Leaves hashed per TreeBuilder batch (even, so pairs never straddle).
+constexpr size_t kLeafBatch = 512;
+
+} // anonymous namespace
+
+void TreeBuilder::Add(const c4::ID &id) {
+    if (count_ > 0) {
+        if (id == last_) {
+            return;
+        }
+        if (id < last_) {
+            throw std::invalid_argument("TreeBuilder: IDs must be added in sorted order");
+        }
+    }
+    last_ = id;
+    count_++;
+
+    if (leaves_.empty()) {
+        leaves_.reserve(kLeafBatch);
+    }
+    leaves_.push_back(id);
+    if (leaves_.size() == kLeafBatch) {
+        flushLeaves();
+    }
+}
+
+void TreeBuilder::flushLeaves() {
+    c4::ID sums[kLeafBatch / 2];
+    c4::ID::SumAdjacent(leaves_.data(), leaves_.size(), sums);
+    for (const auto &sum : sums) {
+        push(1, sum);
+    }
+    leaves_.clear();
+}
+
+void TreeBuilder::push(size_t level, const c4::ID &node) {
+    c4::ID carry = node;
+    for (;; level++) {
+        if (levels_.size() <= level) {
+            levels_.resize(level + 1);
+        }
+        auto &slot = levels_[level];
+        if (!slot) {
+            slot = carry;
+            return;
+        }
+        carry = slot->Sum(carry);
+        slot.reset();
+    }
+}
+
+c4::ID TreeBuilder::Finalize() {
+    for (const auto &leaf : leaves_) {
+        push(0, leaf);
+    }
+
+    std::optional<c4::ID> carry;
+    for (const auto &slot : levels_) {
+        if (slot && carry) {
+            carry = slot->Sum(*carry);
+        } else if (slot) {
+            carry = slot;
+        }
+    }
+
+    Reset();
+    return carry ? *carry : c4::ID();
+}
+
+void TreeBuilder::Reset() {
+    leaves_.clear();
+    levels_.clear();
+    last_ = c4::ID();
+    count_ = 0;
 }
 
 size_t IDs::Size() const {
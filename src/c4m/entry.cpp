@@ -4,11 +4,13 @@
 
 #include "c4/c4m.hpp"
 
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace {
 
@@ -46,6 +48,141 @@ std::string formatTarget(const std::string &t) {
     return out;
 }
 
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's
+// days_from_civil). Linear in d, so an out-of-range day rolls over the
+// way timegm normalizes it.
+constexpr int64_t daysFromCivil(int64_t y, int64_t m, int64_t d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static_assert(daysFromCivil(1970, 1, 1) == 0, "epoch");
+static_assert(daysFromCivil(2000, 3, 1) == 11017, "leap year");
+static_assert(daysFromCivil(1969, 12, 31) == -1, "before epoch");
+
+struct CivilDate {
+    int64_t year;
+    int month;
+    int day;
+};
+
+// Inverse of daysFromCivil.
+constexpr CivilDate civilFromDays(int64_t z) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const int day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    const int month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    return {yoe + era * 400 + (month <= 2), month, day};
+}
+
+// Two decimal digits at p, or -1.
+int digits2(const char *p) {
+    unsigned a = static_cast<unsigned char>(p[0]) - '0';
+    unsigned b = static_cast<unsigned char>(p[1]) - '0';
+    return a <= 9 && b <= 9 ? static_cast<int>(a * 10 + b) : -1;
+}
+
+void put2(char *p, int v) {
+    p[0] = static_cast<char>('0' + v / 10);
+    p[1] = static_cast<char>('0' + v % 10);
+}
+
+// Manifests list many entries from the same day, so the date half of a
+// timestamp is converted once and reused while it repeats.
+struct ParsedDate {
+    char text[10] = {};  // "YYYY-MM-DD"
+    int64_t days = 0;
+};
+
+struct FormattedDate {
+    int64_t days = INT64_MIN;
+    char text[10] = {};
+};
+
+// Fixed-format RFC 3339: "YYYY-MM-DDTHH:MM:SSZ" or
+// "YYYY-MM-DDTHH:MM:SS+hh:mm" (or -hh:mm), with months 01-12. Returns
+// false for anything else, which the sscanf path then handles.
+bool parseFixedTimestamp(std::string_view s, int64_t &out) {
+    const bool utc = s.size() == 20 && s[19] == 'Z';
+    const bool offset = s.size() == 25 && (s[19] == '+' || s[19] == '-') && s[22] == ':';
+    if (!utc && !offset)
+        return false;
+    const char *p = s.data();
+    if (p[4] != '-' || p[7] != '-' || p[10] != 'T' || p[13] != ':' || p[16] != ':')
+        return false;
+
+    thread_local ParsedDate last;
+    int64_t days;
+    if (std::memcmp(p, last.text, sizeof(last.text)) == 0) {
+        days = last.days;
+    } else {
+        int hi = digits2(p), lo = digits2(p + 2), month = digits2(p + 5), day = digits2(p + 8);
+        if (hi < 0 || lo < 0 || month < 1 || month > 12 || day < 0)
+            return false;
+        days = daysFromCivil(hi * 100 + lo, month, day);
+        std::memcpy(last.text, p, sizeof(last.text));
+        last.days = days;
+    }
+
+    int hour = digits2(p + 11), minute = digits2(p + 14), second = digits2(p + 17);
+    if (hour < 0 || minute < 0 || second < 0)
+        return false;
+    int64_t ts = days * 86400 + hour * 3600 + minute * 60 + second;
+
+    if (offset) {
+        int tz_h = digits2(p + 20), tz_m = digits2(p + 23);
+        if (tz_h < 0 || tz_m < 0)
+            return false;
+        int offset_sec = tz_h * 3600 + tz_m * 60;
+        ts += p[19] == '+' ? -offset_sec : offset_sec;
+    }
+    out = ts;
+    return true;
+}
+
+// Write "YYYY-MM-DDTHH:MM:SSZ" to out (20 chars). Returns false if the year
+// is outside 0000-9999, which the gmtime path then handles.
+bool formatFixedTimestamp(int64_t ts, char *out) {
+    int64_t days = ts / 86400;
+    int64_t secs = ts % 86400;
+    if (secs < 0) {
+        secs += 86400;
+        days--;
+    }
+
+    thread_local FormattedDate last;
+    if (days != last.days) {
+        CivilDate date = civilFromDays(days);
+        if (date.year < 0 || date.year > 9999)
+            return false;
+        put2(last.text, static_cast<int>(date.year / 100));
+        put2(last.text + 2, static_cast<int>(date.year % 100));
+        last.text[4] = '-';
+        put2(last.text + 5, date.month);
+        last.text[7] = '-';
+        put2(last.text + 8, date.day);
+        last.days = days;
+    }
+
+    std::memcpy(out, last.text, sizeof(last.text));
+    out[10] = 'T';
+    put2(out + 11, static_cast<int>(secs / 3600));
+    out[13] = ':';
+    put2(out + 14, static_cast<int>(secs / 60 % 60));
+    out[16] = ':';
+    put2(out + 17, static_cast<int>(secs % 60));
+    out[19] = 'Z';
+    return true;
+}
+
 } // anonymous namespace
 
 namespace c4m {
@@ -104,7 +241,7 @@ std::string FormatMode(uint32_t mode) {
     return buf;
 }
 
-uint32_t ParseMode(const std::string &s) {
+uint32_t ParseMode(std::string_view s) {
     if (s.size() != 10)
         throw std::invalid_argument("mode must be 10 characters");
 
@@ -143,6 +280,10 @@ std::string FormatTimestamp(int64_t ts) {
     if (ts == NullTimestamp)
         return "-";
 
+    char fixed[20];
+    if (formatFixedTimestamp(ts, fixed))
+        return std::string(fixed, sizeof(fixed));
+
     time_t t = static_cast<time_t>(ts);
     struct tm utc{};
 #ifdef _WIN32
@@ -157,14 +298,25 @@ std::string FormatTimestamp(int64_t ts) {
     return buf;
 }
 
-int64_t ParseTimestamp(const std::string &s) {
+int64_t ParseTimestamp(std::string_view s) {
     if (s == "-" || s == "0")
         return NullTimestamp;
 
+    int64_t fixed;
+    if (parseFixedTimestamp(s, fixed))
+        return fixed;
+
+    // sscanf needs a terminated string; valid timestamps are 20 or 25 chars.
+    char text[32];
+    if (s.empty() || s.size() >= sizeof(text))
+        throw std::invalid_argument("cannot parse timestamp: " + std::string(s));
+    std::memcpy(text, s.data(), s.size());
+    text[s.size()] = '\0';
+
     int year, month, day, hour, minute, second;
 
     if (s.back() == 'Z' &&
-        std::sscanf(s.c_str(), "%d-%d-%dT%d:%d:%dZ",
+        std::sscanf(text, "%d-%d-%dT%d:%d:%dZ",
                     &year, &month, &day, &hour, &minute, &second) == 6) {
         struct tm t{};
         t.tm_year = year - 1900;
@@ -182,7 +334,7 @@ int64_t ParseTimestamp(const std::string &s) {
 
     int tz_h, tz_m;
     char tz_sign;
-    if (std::sscanf(s.c_str(), "%d-%d-%dT%d:%d:%d%c%d:%d",
+    if (std::sscanf(text, "%d-%d-%dT%d:%d:%d%c%d:%d",
                     &year, &month, &day, &hour, &minute, &second,
                     &tz_sign, &tz_h, &tz_m) == 9 &&
         (tz_sign == '+' || tz_sign == '-')) {
@@ -204,7 +356,7 @@ int64_t ParseTimestamp(const std::string &s) {
         return base;
     }
 
-    throw std::invalid_argument("cannot parse timestamp: " + s);
+    throw std::invalid_argument("cannot parse timestamp: " + std::string(s));
 }
 
 // Canonical form: null mode is "-" (single dash), no indentation.
@@ -251,8 +403,10 @@ std::string Entry::Canonical() const {
 
     // C4 ID or "-" is always the last field
     if (!id.IsNil()) {
+        char encoded[c4::IDLen];
+        id.EncodeTo(encoded);
         line += ' ';
-        line += id.String();
+        line.append(encoded, c4::IDLen);
     } else {
         line += " -";
     }
@@ -304,8 +458,10 @@ std::string Entry::Format(int indent_width) const {
 
     // C4 ID or "-" is always the last field
     if (!id.IsNil()) {
+        char encoded[c4::IDLen];
+        id.EncodeTo(encoded);
         line += ' ';
-        line += id.String();
+        line.append(encoded, c4::IDLen);
     } else {
         line += " -";
     }
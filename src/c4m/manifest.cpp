@@ -70,6 +70,16 @@ std::vector<const Entry *> Manifest::AllEntries() const {
     return result;
 }
 
+c4::IDs Manifest::EntryIDs() const {
+    c4::IDs ids;
+    ids.Reserve(entries_.size());
+    for (const auto &e : entries_) {
+        if (!e.id.IsNil())
+            ids.Append(e.id);
+    }
+    return ids;
+}
+
 // ====================================================================
 // Tree Index
 // ====================================================================
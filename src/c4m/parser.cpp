@@ -2,281 +2,378 @@
 // C4M format parser -- streaming line-by-line decoder.
 // Matches Go reference: github.com/Avalanche-io/c4/c4m/decoder.go
 // Format is entry-only: no header, no directives. Lines starting with @ are rejected.
+//
+// The decoder consumes lines as string_views. Contiguous input (a caller's
+// string_view, or a file mapped with mmap) is split in place with memchr,
+// so reading it costs no copies; only std::istream input is read line by
+// line into a reused buffer. Large buffers can also be split into chunks
+// that are tokenized on several threads (see parseChunks). ManifestReader
+// runs the same tokenizer one entry at a time, without building a Manifest.
 
 #include "c4/c4m.hpp"
+#include "../c4/parallel.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdio>
+#include <cstring>
+#include <exception>
 #include <fstream>
-#include <regex>
-#include <sstream>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace {
 
-// Read a line from stream. Rejects CR (0x0D) per spec.
-bool readLine(std::istream &in, std::string &line, int &line_num) {
-    if (!std::getline(in, line))
-        return false;
-    line_num++;
+// Reject CR (0x0D) per spec: c4m requires LF-only line endings.
+void checkNoCR(std::string_view line, int line_num) {
+    if (std::memchr(line.data(), '\r', line.size())) {
+        throw std::runtime_error("c4m: line " + std::to_string(line_num) +
+                                 ": CR (0x0D) not allowed -- c4m requires LF-only line endings");
+    }
+}
 
-    // Reject CR: c4m requires LF-only line endings.
-    for (char c : line) {
-        if (c == '\r') {
-            throw std::runtime_error("c4m: line " + std::to_string(line_num) +
-                                     ": CR (0x0D) not allowed -- c4m requires LF-only line endings");
+// Lines of a contiguous buffer, as views into it. Same splitting as
+// std::getline: a final line without '\n' still counts, an empty tail
+// does not.
+class BufferLines {
+public:
+    explicit BufferLines(std::string_view data) : data_(data) {}
+
+    bool Next(std::string_view &line, int &line_num) {
+        if (pos_ >= data_.size())
+            return false;
+        const char *start = data_.data() + pos_;
+        size_t left = data_.size() - pos_;
+        const void *nl = std::memchr(start, '\n', left);
+        size_t len = nl ? static_cast<size_t>(static_cast<const char *>(nl) - start) : left;
+        line = std::string_view(start, len);
+        pos_ += nl ? len + 1 : len;
+        line_num++;
+        checkNoCR(line, line_num);
+        return true;
+    }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+};
+
+// Lines of a stream, read into one reused buffer.
+class StreamLines {
+public:
+    explicit StreamLines(std::istream &in) : in_(in) {}
+
+    bool Next(std::string_view &line, int &line_num) {
+        if (!std::getline(in_, buf_))
+            return false;
+        line = buf_;
+        line_num++;
+        checkNoCR(line, line_num);
+        return true;
+    }
+
+private:
+    std::istream &in_;
+    std::string buf_;
+};
+
+#ifndef _WIN32
+// Read-only mapping of a whole file; empty if the file cannot be mapped
+// (e.g. a pipe or an empty file), in which case callers fall back to
+// reading it as a stream.
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path &path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            size_t len = static_cast<size_t>(st.st_size);
+            void *p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                ::madvise(p, len, MADV_SEQUENTIAL);
+                data_ = p;
+                len_ = len;
+            }
         }
+        ::close(fd);
     }
-    return true;
-}
+    ~MappedFile() {
+        if (data_)
+            ::munmap(data_, len_);
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool Mapped() const { return data_ != nullptr; }
+    std::string_view View() const { return {static_cast<const char *>(data_), len_}; }
+
+private:
+    void *data_ = nullptr;
+    size_t len_ = 0;
+};
+#endif
 
 // Check if a string is a bare C4 ID (exactly 90 chars, starts with "c4").
-bool isBareC4ID(const std::string &s) {
+bool isBareC4ID(std::string_view s) {
     return s.size() == 90 && s[0] == 'c' && s[1] == '4';
 }
 
-// c4IDPattern for validation of each 90-char chunk.
-static const std::regex &c4IDPatternRe() {
-    static const std::regex re("^c4[1-9A-HJ-NP-Za-km-z]{88}$");
-    return re;
-}
-
 // Check if a line is an inline ID list (len > 90, multiple of 90, all valid C4 IDs).
-bool isInlineIDList(const std::string &s) {
+bool isInlineIDList(std::string_view s) {
     size_t n = s.size();
     if (n <= 90 || n % 90 != 0 || s[0] != 'c' || s[1] != '4')
         return false;
     for (size_t i = 0; i < n; i += 90) {
-        if (!std::regex_match(s.begin() + static_cast<long>(i),
-                              s.begin() + static_cast<long>(i + 90),
-                              c4IDPatternRe()))
+        if (!c4::IsValidIDString(s.substr(i, 90)))
             return false;
     }
     return true;
 }
 
-// Parse a backslash-escaped name or target. Field-boundary escapes only:
-// \<space> -> space, \" -> ", \[ -> [, \] -> ]
-// All other backslash sequences pass through for UnsafeName.
-// Returns the parsed string and advances pos.
-// If is_name is true, '/' terminates the name (inclusive, for directories).
-// Boundary detection: space followed by ->, <-, <>, c4 prefix, or -.
-struct NameResult {
-    std::string value;
-    std::string raw;
-    bool has_unescaped_brackets = false;
+// Character classes for the entry tokenizer, one table lookup per byte.
+enum : uint8_t {
+    kNameStop = 1,    // may end a name or start an escape: space \ /
+    kTargetStop = 2,  // the same for symlink targets: space \ (no /)
+    kSeqChar = 4,     // inside sequence brackets: 0-9 , - :
+    kLabelChar = 8,   // flow target label: A-Z a-z 0-9 _ -
 };
 
-NameResult parseNameOrTarget(const std::string &line, size_t &pos, bool is_name) {
-    size_t n = line.size();
-    NameResult result;
-    size_t raw_start = pos;
-
-    while (pos < n) {
-        char ch = line[pos];
+constexpr std::array<uint8_t, 256> makeCharClasses() {
+    std::array<uint8_t, 256> t{};
+    t[' '] = kNameStop | kTargetStop;
+    t['\\'] = kNameStop | kTargetStop;
+    t['/'] = kNameStop;
+    for (int c = '0'; c <= '9'; c++)
+        t[c] = kSeqChar | kLabelChar;
+    for (int c = 'a'; c <= 'z'; c++)
+        t[c] = kLabelChar;
+    for (int c = 'A'; c <= 'Z'; c++)
+        t[c] = kLabelChar;
+    t[','] = kSeqChar;
+    t[':'] = kSeqChar;
+    t['-'] = kSeqChar | kLabelChar;
+    t['_'] = kLabelChar;
+    return t;
+}
 
-        // Field-boundary backslash escapes
-        if (ch == '\\' && pos + 1 < n) {
-            char next = line[pos + 1];
-            if (next == ' ' || next == '"' || next == '[' || next == ']') {
-                result.value += next;
-                pos += 2;
-                continue;
-            }
-        }
+constexpr std::array<uint8_t, 256> kCharClasses = makeCharClasses();
 
-        if (ch == '[' || ch == ']') {
-            result.has_unescaped_brackets = true;
-        }
+bool inClass(char c, uint8_t cls) {
+    return (kCharClasses[static_cast<unsigned char>(c)] & cls) != 0;
+}
 
-        // Directory name ends at / (inclusive)
-        if (is_name && ch == '/') {
-            result.value += '/';
-            pos++;
-            result.raw = line.substr(raw_start, pos - raw_start);
-            return result;
-        }
+bool isLetter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
 
-        // Boundary: space followed by link operator, c4 prefix, or null marker
-        if (ch == ' ') {
-            std::string_view rest(line.data() + pos, n - pos);
-            if (rest.substr(0, 4) == " -> " ||
-                rest.substr(0, 4) == " <- " ||
-                rest.substr(0, 4) == " <> ")
-            {
-                result.raw = line.substr(raw_start, pos - raw_start);
-                return result;
-            }
-            // Hard link group: " ->N" where N is digit 1-9
-            if (rest.size() >= 4 && rest[1] == '-' && rest[2] == '>' &&
-                rest[3] >= '1' && rest[3] <= '9')
-            {
-                result.raw = line.substr(raw_start, pos - raw_start);
-                return result;
-            }
-            if (rest.size() > 2 && rest[1] == 'c' && rest[2] == '4') {
-                result.raw = line.substr(raw_start, pos - raw_start);
-                return result;
-            }
-            if (rest.size() >= 2 && rest[1] == '-' && (rest.size() == 2 || rest[2] == ' ')) {
-                result.raw = line.substr(raw_start, pos - raw_start);
-                return result;
-            }
-        }
+// A space at line[pos] ends a symlink or flow target when a C4 ID or a
+// null marker follows: " c4", or " -" at the end or before a space.
+bool endsTarget(std::string_view line, size_t pos) {
+    std::string_view rest = line.substr(pos);
+    if (rest.size() > 2 && rest[1] == 'c' && rest[2] == '4')
+        return true;
+    return rest.size() >= 2 && rest[1] == '-' && (rest.size() == 2 || rest[2] == ' ');
+}
 
-        result.value += ch;
-        pos++;
+// A space ends a name where it ends a target, and also before a link
+// operator: " -> ", " <- ", " <> ", or a hard link group " ->N" (N 1-9).
+bool endsName(std::string_view line, size_t pos) {
+    std::string_view rest = line.substr(pos);
+    if (rest.size() >= 4) {
+        std::string_view op = rest.substr(1, 2);
+        char next = rest[3];
+        if ((op == "->" && (next == ' ' || (next >= '1' && next <= '9'))) ||
+            ((op == "<-" || op == "<>") && next == ' '))
+            return true;
     }
+    return endsTarget(line, pos);
+}
 
-    result.raw = line.substr(raw_start, pos - raw_start);
-    return result;
+// Field-boundary escapes: a backslash before space or '"' in names and
+// targets, and before '[' or ']' in names only. Other backslash sequences
+// are SafeName escapes and pass through to UnsafeName.
+bool isFieldEscape(char c, bool is_name) {
+    return c == ' ' || c == '"' || (is_name && (c == '[' || c == ']'));
 }
 
-// Parse symlink target. Unlike name, '/' is NOT a boundary.
-std::string parseSymlinkTarget(const std::string &line, size_t &pos) {
-    size_t n = line.size();
-    std::string buf;
+// A name or symlink target as written in the line.
+struct Field {
+    std::string_view raw;
+    bool escaped = false;  // contains field-boundary escapes
+};
+
+// Scan a name (is_name) or a symlink target starting at pos, and advance
+// pos past it. A name ends after '/' (inclusive, for directories) or at a
+// space before a link operator, C4 ID or null marker; '/' is not a
+// boundary in a target.
+Field scanField(std::string_view line, size_t &pos, bool is_name) {
+    const uint8_t stop = is_name ? kNameStop : kTargetStop;
+    const size_t n = line.size();
+    const size_t start = pos;
+    Field field;
 
     while (pos < n) {
-        char ch = line[pos];
+        while (pos < n && !inClass(line[pos], stop))
+            pos++;
+        if (pos == n)
+            break;
 
-        // Backslash escapes for space and quote
-        if (ch == '\\' && pos + 1 < n) {
-            char next = line[pos + 1];
-            if (next == ' ' || next == '"') {
-                buf += next;
-                pos += 2;
-                continue;
+        char ch = line[pos];
+        if (ch == '\\') {
+            if (pos + 1 < n && isFieldEscape(line[pos + 1], is_name)) {
+                field.escaped = true;
+                pos++;
             }
+            pos++;
+        } else if (ch == '/') {
+            pos++;
+            break;
+        } else if (is_name ? endsName(line, pos) : endsTarget(line, pos)) {
+            break;
+        } else {
+            pos++;
         }
+    }
 
-        if (ch == ' ') {
-            std::string_view rest(line.data() + pos, n - pos);
-            if (rest.size() > 2 && rest[1] == 'c' && rest[2] == '4') {
-                return buf;
-            }
-            if (rest.size() >= 2 && rest[1] == '-' && (rest.size() == 2 || rest[2] == ' ')) {
-                return buf;
-            }
-        }
+    field.raw = line.substr(start, pos - start);
+    return field;
+}
 
-        buf += ch;
-        pos++;
+// Decode a field into out, reusing its storage: field-boundary escapes,
+// then SafeName encoding, undone. A field with neither (no backslash, no
+// currency sign lead byte) is copied once.
+void decodeField(const Field &field, bool is_name, std::string &out) {
+    if (field.raw.find('\\') == std::string_view::npos &&
+        field.raw.find('\xC2') == std::string_view::npos) {
+        out.assign(field.raw);
+        return;
+    }
+    if (!field.escaped) {
+        out = c4m::UnsafeName(field.raw);
+        return;
     }
 
-    return buf;
+    std::string buf;
+    buf.reserve(field.raw.size());
+    for (size_t i = 0; i < field.raw.size(); i++) {
+        if (field.raw[i] == '\\' && i + 1 < field.raw.size() &&
+            isFieldEscape(field.raw[i + 1], is_name))
+            i++;
+        buf += field.raw[i];
+    }
+    out = c4m::UnsafeName(buf);
 }
 
 // Check if text at position looks like a flow target (label: pattern).
-bool isFlowTarget(const std::string &s, size_t pos) {
-    if (pos >= s.size()) return false;
-    char ch = s[pos];
-    if (!((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z')))
+bool isFlowTarget(std::string_view s, size_t pos) {
+    if (pos >= s.size() || !isLetter(s[pos]))
         return false;
     for (size_t i = pos + 1; i < s.size(); i++) {
-        char c = s[i];
-        if (c == ':') return true;
-        if (c == ' ') return false;
-        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
-              (c >= '0' && c <= '9') || c == '_' || c == '-'))
+        if (s[i] == ':')
+            return true;
+        if (!inClass(s[i], kLabelChar))
             return false;
     }
     return false;
 }
 
-// Parse flow target: ends at space followed by c4 or -, or end of line.
-std::string parseFlowTarget(const std::string &line, size_t &pos) {
-    size_t n = line.size();
+// Scan flow target: ends at space followed by c4 or -, or end of line.
+std::string_view scanFlowTarget(std::string_view line, size_t &pos) {
     size_t start = pos;
-    while (pos < n) {
-        char ch = line[pos];
-        if (ch == ' ') {
-            std::string_view rest(line.data() + pos, n - pos);
-            if (rest.size() > 2 && rest[1] == 'c' && rest[2] == '4') {
-                return line.substr(start, pos - start);
-            }
-            if (rest.size() >= 2 && rest[1] == '-' && (rest.size() == 2 || rest[2] == ' ')) {
-                return line.substr(start, pos - start);
-            }
-        }
+    while (pos < line.size() && !(line[pos] == ' ' && endsTarget(line, pos)))
         pos++;
-    }
     return line.substr(start, pos - start);
 }
 
 // Skip spaces, return count.
-size_t skipSpaces(const std::string &line, size_t &pos) {
+size_t skipSpaces(std::string_view line, size_t &pos) {
     size_t start = pos;
     while (pos < line.size() && line[pos] == ' ')
         pos++;
     return pos - start;
 }
 
-// Sequence pattern regex for detecting [0001-0100] style ranges
-static const std::regex &sequencePatternRe() {
-    static const std::regex re("\\[([0-9,\\-:]+)\\]");
-    return re;
+// Check if a raw name has unescaped sequence notation: '[', one or more of
+// 0-9 , - :, then ']' (e.g. "[0001-0100]"). An escaped character never
+// takes part in a match.
+bool hasUnescapedSequenceNotation(std::string_view raw) {
+    const size_t n = raw.size();
+    size_t i = 0;
+    while (i < n) {
+        if (raw[i] == '\\' && i + 1 < n) {
+            i += 2;
+        } else if (raw[i] != '[') {
+            i++;
+        } else {
+            size_t j = i + 1;
+            while (j < n && inClass(raw[j], kSeqChar))
+                j++;
+            if (j > i + 1 && j < n && raw[j] == ']')
+                return true;
+            i = j;  // resume at the character that broke the run
+        }
+    }
+    return false;
 }
 
-// Check if raw text has unescaped sequence notation.
-bool hasUnescapedSequenceNotation(const std::string &raw) {
-    // Replace all escape sequences with neutral chars so escaped brackets don't match.
-    std::string buf;
-    buf.reserve(raw.size());
-    for (size_t i = 0; i < raw.size(); i++) {
-        if (raw[i] == '\\' && i + 1 < raw.size()) {
-            buf += '_';
-            buf += '_';
-            i++;
+// Decimal digits of s with ',' separators skipped. Throws on overflow of
+// max or when there are no digits.
+int64_t parseDigits(std::string_view s, int64_t max, const char *what, int line_num) {
+    int64_t v = 0;
+    bool any = false;
+    for (char c : s) {
+        if (c == ',')
             continue;
-        }
-        buf += raw[i];
+        int d = c - '0';
+        if (v > (max - d) / 10)
+            throw std::runtime_error("c4m: line " + std::to_string(line_num) + ": " +
+                                     what + " out of range");
+        v = v * 10 + d;
+        any = true;
     }
-    return std::regex_search(buf, sequencePatternRe());
+    if (!any)
+        throw std::runtime_error("c4m: line " + std::to_string(line_num) + ": invalid " + what);
+    return v;
 }
 
 } // anonymous namespace
 
 namespace c4m {
 
-Manifest Manifest::Parse(std::string_view data) {
-    std::istringstream ss{std::string(data)};
-    return Parse(ss);
-}
-
-Manifest Manifest::ParseFile(const std::filesystem::path &path) {
-    std::ifstream f(path, std::ios::binary);
-    if (!f.is_open())
-        throw std::runtime_error("cannot open file: " + path.string());
-    return Parse(f);
-}
-
-// parseEntryFromLine parses one manifest entry from a full (indentation-included)
-// line. It detects and updates indent_width (auto-detected from the first
-// indented line). Mirrors the Go reference decoder.parseEntryFromLine.
-static Entry parseEntryFromLine(const std::string &line, int &indent_width, int line_num) {
-    // Detect indentation
-    size_t indent = 0;
-    while (indent < line.size() && line[indent] == ' ')
-        indent++;
-
-    if (indent_width < 0 && indent > 0)
-        indent_width = static_cast<int>(indent);
-
-    int depth = 0;
-    if (indent_width > 0 && indent > 0)
-        depth = static_cast<int>(indent) / indent_width;
-
+// parseEntry parses one manifest entry from a full (indentation-included)
+// line whose first `indent` characters are spaces, overwriting every field
+// of entry and reusing its strings' storage. Mirrors the Go reference
+// decoder.parseEntryFromLine, except that depth is left at 0: it depends on
+// the indentation width of earlier lines (see IndentTracker).
+// Fields are sliced out of the line without copies; only the decoded name,
+// target and flow target are stored as strings.
+// If id_text is given, a valid C4 ID is not decoded but copied there for a
+// later batch decode (entry.id stays nil); an invalid one throws as usual.
+static void parseEntry(std::string_view line, size_t indent, int line_num, Entry &entry,
+                       std::string *id_text = nullptr) {
     // Content after indentation
-    std::string content = line.substr(indent);
+    std::string_view content = line.substr(indent);
     if (content.empty())
         throw std::runtime_error("c4m: line " + std::to_string(line_num) +
                                  ": empty entry");
 
     // Parse mode
     size_t pos = 0;
-    std::string mode_str;
+    std::string_view mode_str;
 
     if (content.size() >= 2 && content[0] == '-' && content[1] == ' ') {
         mode_str = "-";
@@ -294,16 +391,22 @@ static Entry parseEntryFromLine(const std::string &line, int &indent_width, int
         mode = ParseMode(mode_str);
     }
 
-    Entry entry;
     entry.mode = mode;
-    entry.depth = depth;
+    entry.target.clear();
+    entry.id = c4::ID();
+    entry.depth = 0;
+    entry.hard_link = 0;
+    entry.flow_direction = FlowDirection::None;
+    entry.flow_target.clear();
+    entry.is_sequence = false;
+    entry.pattern.clear();
 
     // Parse timestamp
     if (pos >= content.size())
         throw std::runtime_error("c4m: line " + std::to_string(line_num) +
                                  ": missing timestamp");
 
-    std::string ts_str;
+    std::string_view ts_str;
     if (content[pos] == '-' && (pos + 1 >= content.size() || content[pos + 1] == ' ')) {
         ts_str = "-";
         pos += 2;
@@ -341,15 +444,8 @@ static Entry parseEntryFromLine(const std::string &line, int &indent_width, int
         while (pos < content.size() &&
                ((content[pos] >= '0' && content[pos] <= '9') || content[pos] == ','))
             pos++;
-        if (pos == size_start)
-            throw std::runtime_error("c4m: line " + std::to_string(line_num) +
-                                     ": invalid size");
-        std::string size_str;
-        for (size_t i = size_start; i < pos; i++) {
-            if (content[i] != ',')
-                size_str += content[i];
-        }
-        entry.size = std::stoll(size_str);
+        entry.size = parseDigits(content.substr(size_start, pos - size_start),
+                                 std::numeric_limits<int64_t>::max(), "size", line_num);
     }
 
     // Skip space after size
@@ -360,11 +456,11 @@ static Entry parseEntryFromLine(const std::string &line, int &indent_width, int
         throw std::runtime_error("c4m: line " + std::to_string(line_num) +
                                  ": missing name");
 
-    auto name_result = parseNameOrTarget(content, pos, true);
-    entry.name = UnsafeName(name_result.value);
+    Field name = scanField(content, pos, true);
+    decodeField(name, true, entry.name);
 
     // Check for sequence notation in raw name
-    if (hasUnescapedSequenceNotation(name_result.raw)) {
+    if (hasUnescapedSequenceNotation(name.raw)) {
         entry.is_sequence = true;
         entry.pattern = entry.name;
     }
@@ -382,7 +478,7 @@ static Entry parseEntryFromLine(const std::string &line, int &indent_width, int
             // Symlink mode: -> is always a symlink target
             skipSpaces(content, pos);
             if (pos < content.size()) {
-                entry.target = UnsafeName(parseSymlinkTarget(content, pos));
+                decodeField(scanField(content, pos, false), false, entry.target);
                 skipSpaces(content, pos);
             }
         } else if (pos < content.size() && content[pos] >= '1' && content[pos] <= '9') {
@@ -390,7 +486,9 @@ static Entry parseEntryFromLine(const std::string &line, int &indent_width, int
             size_t group_start = pos;
             while (pos < content.size() && content[pos] >= '0' && content[pos] <= '9')
                 pos++;
-            entry.hard_link = std::stoi(content.substr(group_start, pos - group_start));
+            entry.hard_link = static_cast<int>(
+                parseDigits(content.substr(group_start, pos - group_start),
+                            std::numeric_limits<int>::max(), "hard link group", line_num));
             skipSpaces(content, pos);
         } else {
             skipSpaces(content, pos);
@@ -398,21 +496,18 @@ static Entry parseEntryFromLine(const std::string &line, int &indent_width, int
             // Determine type by examining token after ->
             if (pos < content.size() && isFlowTarget(content, pos)) {
                 entry.flow_direction = FlowDirection::Outbound;
-                entry.flow_target = parseFlowTarget(content, pos);
+                entry.flow_target.assign(scanFlowTarget(content, pos));
                 skipSpaces(content, pos);
             } else {
-                std::string remaining;
-                if (pos < content.size()) {
-                    remaining = content.substr(pos);
-                    while (!remaining.empty() && remaining.back() == ' ')
-                        remaining.pop_back();
-                }
+                std::string_view remaining = content.substr(pos);
+                while (!remaining.empty() && remaining.back() == ' ')
+                    remaining.remove_suffix(1);
                 if (remaining == "-" || (remaining.size() >= 2 && remaining[0] == 'c' && remaining[1] == '4')) {
                     // Hard link (ungrouped)
                     entry.hard_link = -1;
                 } else if (pos < content.size()) {
                     // Fallback: treat as symlink target
-                    entry.target = UnsafeName(parseSymlinkTarget(content, pos));
+                    decodeField(scanField(content, pos, false), false, entry.target);
                     skipSpaces(content, pos);
                 }
             }
@@ -421,29 +516,38 @@ static Entry parseEntryFromLine(const std::string &line, int &indent_width, int
         pos += 2;
         skipSpaces(content, pos);
         entry.flow_direction = FlowDirection::Inbound;
-        entry.flow_target = parseFlowTarget(content, pos);
+        entry.flow_target.assign(scanFlowTarget(content, pos));
         skipSpaces(content, pos);
     } else if (pos + 1 < content.size() && content[pos] == '<' && content[pos + 1] == '>') {
         pos += 2;
         skipSpaces(content, pos);
         entry.flow_direction = FlowDirection::Bidirectional;
-        entry.flow_target = parseFlowTarget(content, pos);
+        entry.flow_target.assign(scanFlowTarget(content, pos));
         skipSpaces(content, pos);
     }
 
     // Parse C4 ID or null marker
     if (pos < content.size()) {
-        std::string remaining = content.substr(pos);
+        std::string_view remaining = content.substr(pos);
         while (!remaining.empty() && remaining.back() == ' ')
-            remaining.pop_back();
+            remaining.remove_suffix(1);
 
         if (remaining == "-") {
             // Null C4 ID
         } else if (remaining.size() >= 2 && remaining[0] == 'c' && remaining[1] == '4') {
-            entry.id = c4::ID::Parse(remaining);
+            if (id_text && c4::IsValidIDString(remaining)) {
+                id_text->assign(remaining);
+            } else {
+                entry.id = c4::ID::Parse(remaining);
+            }
         }
     }
+}
 
+static Entry parseEntryFromLine(std::string_view line, size_t indent, int line_num,
+                                std::string *id_text = nullptr) {
+    Entry entry;
+    parseEntry(line, indent, line_num, entry, id_text);
     return entry;
 }
 
@@ -468,87 +572,410 @@ static void applyChainSection(Manifest &m, std::vector<Entry> &section, bool pat
     section.clear();
 }
 
+// Entry IDs of the current section, decoded together with c4::ParseIDs
+// when the section is flushed. Each ID is validated as its line is read,
+// so parse errors are still raised in line order.
+struct DeferredIDs {
+    std::string text;             // IDs back to back, IDLen characters each
+    std::vector<size_t> entries;  // section index of each ID
+
+    void Add(size_t entry, std::string_view id) {
+        text.append(id);
+        entries.push_back(entry);
+    }
+
+    void Flush(std::vector<Entry> &section) {
+        if (entries.empty())
+            return;
+        std::vector<c4::ID> ids(entries.size());
+        c4::ParseIDs(text.data(), ids.size(), ids.data());
+        for (size_t i = 0; i < ids.size(); i++)
+            section[entries[i]].id = ids[i];
+        text.clear();
+        entries.clear();
+    }
+};
+
+enum class LineKind { Skip, Boundary, Entry };
+
+// Classify a line and set indent to its count of leading spaces. Blank
+// lines and inline ID lists (range data lines) are skipped; a bare C4 ID
+// is a patch boundary (base reference or checkpoint). Lines starting with
+// @ are rejected: directives are not supported (Go reference behavior).
+static LineKind classifyLine(std::string_view line, int line_num, size_t &indent) {
+    indent = line.find_first_not_of(' ');
+    if (indent == std::string_view::npos)
+        return LineKind::Skip;
+    std::string_view trimmed = line.substr(indent);
+
+    if (isInlineIDList(trimmed))
+        return LineKind::Skip;
+    if (isBareC4ID(trimmed))
+        return LineKind::Boundary;
+    if (trimmed[0] == '@') {
+        throw std::runtime_error("c4m: directives not supported (line " +
+                                 std::to_string(line_num) + "): " + std::string(line));
+    }
+    return LineKind::Entry;
+}
+
+// Depth of entries from their indentation. The indentation width is
+// auto-detected from the first indented entry.
+struct IndentTracker {
+    int width = -1;
+
+    int Depth(size_t indent) {
+        if (width < 0 && indent > 0)
+            width = static_cast<int>(indent);
+        if (width > 0 && indent > 0)
+            return static_cast<int>(indent) / width;
+        return 0;
+    }
+};
+
+// ChainBuilder assembles a manifest from entries and boundaries in line
+// order. It sets each entry's depth and resolves the chain.
+//
+// Chain resolution: entries accumulate in a section between bare-C4-ID
+// boundaries. A bare ID resolves as follows (grammar erratum 2026-07-13,
+// matching Go reference decoder.go):
+//   - first non-blank line, no entries yet -> external base reference
+//   - otherwise a checkpoint naming the accumulated manifest state: flush
+//     the pending section (base append or patch apply), then verify the
+//     accumulated C4 ID against the checkpoint (reject on mismatch).
+// A trailing bare ID at EOF is the closing validator (verified above);
+// consecutive checkpoints re-verify the same state and are accepted.
+// Verification is skipped once an external base reference is present.
+class ChainBuilder {
+public:
+    // id_text is the entry's C4 ID if its decoding was deferred, else empty.
+    void Add(Entry entry, size_t indent, std::string_view id_text) {
+        entry.depth = indents_.Depth(indent);
+        section_.push_back(std::move(entry));
+        if (!id_text.empty())
+            section_ids_.Add(section_.size() - 1, id_text);
+        first_line_ = false;
+    }
+
+    void Boundary(const c4::ID &id, int line_num) {
+        if (first_line_ && section_.empty()) {
+            // First line of stream: external base reference.
+            m_.SetBase(id);
+        } else {
+            section_ids_.Flush(section_);
+            applyChainSection(m_, section_, patch_mode_);
+            patch_mode_ = true;
+
+            // A resolving decoder MUST verify checkpoints -- except after
+            // an unresolved external base reference, where the accumulated
+            // state is unknowable here.
+            if (m_.Base().IsNil()) {
+                c4::ID got = m_.ComputeC4ID();
+                if (got != id) {
+                    throw std::runtime_error(
+                        "c4m: patch ID mismatch (line " + std::to_string(line_num) +
+                        "): accumulated " + got.String() + ", checkpoint " + id.String());
+                }
+            }
+        }
+        first_line_ = false;
+    }
+
+    // Flush the trailing section. A stream may end without a closing validator
+    // (final patch applies unverified, C4M-STANDARD 10.7); a stream ending in a
+    // bare C4 ID already flushed an empty section and verified above.
+    Manifest Finish() {
+        section_ids_.Flush(section_);
+        applyChainSection(m_, section_, patch_mode_);
+        return std::move(m_);
+    }
+
+private:
+    Manifest m_;
+    std::vector<Entry> section_;
+    DeferredIDs section_ids_;
+    IndentTracker indents_;
+    bool first_line_ = true;
+    bool patch_mode_ = false;
+};
+
+// Decode a manifest from any line source (BufferLines or StreamLines).
+template <typename Lines>
+static Manifest parseLines(Lines &lines) {
+    ChainBuilder chain;
+    std::string id_text;
+    std::string_view line;
+    int line_num = 0;
+    size_t indent = 0;
+
+    while (lines.Next(line, line_num)) {
+        switch (classifyLine(line, line_num, indent)) {
+        case LineKind::Skip:
+            break;
+        case LineKind::Boundary:
+            chain.Boundary(c4::ID::Parse(line.substr(indent)), line_num);
+            break;
+        case LineKind::Entry: {
+            id_text.clear();
+            Entry entry = parseEntryFromLine(line, indent, line_num, &id_text);
+            chain.Add(std::move(entry), indent, id_text);
+            break;
+        }
+        }
+    }
+    return chain.Finish();
+}
+
+// The lines of one chunk of a buffer, tokenized on a worker thread: its
+// entries (IDs decoded) with their indentation, and the boundaries
+// between them. Parsing stops at the first error, which is kept so the
+// sequential pass raises it after everything that precedes it.
+struct ParsedChunk {
+    struct Boundary {
+        size_t entries;  // chunk entries before it
+        c4::ID id;
+        int line_num;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<size_t> indents;
+    std::vector<Boundary> boundaries;
+    std::exception_ptr error;
+};
+
+// first_line is the number of lines before the chunk.
+static void parseChunk(std::string_view data, int first_line, ParsedChunk &out) {
+    BufferLines lines(data);
+    DeferredIDs ids;
+    std::string id_text;
+    std::string_view line;
+    int line_num = first_line;
+    size_t indent = 0;
+
+    try {
+        while (lines.Next(line, line_num)) {
+            switch (classifyLine(line, line_num, indent)) {
+            case LineKind::Skip:
+                break;
+            case LineKind::Boundary:
+                out.boundaries.push_back(
+                    {out.entries.size(), c4::ID::Parse(line.substr(indent)), line_num});
+                break;
+            case LineKind::Entry:
+                id_text.clear();
+                out.entries.push_back(parseEntryFromLine(line, indent, line_num, &id_text));
+                out.indents.push_back(indent);
+                if (!id_text.empty())
+                    ids.Add(out.entries.size() - 1, id_text);
+                break;
+            }
+        }
+    } catch (...) {
+        out.error = std::current_exception();
+    }
+    ids.Flush(out.entries);
+}
+
+// Multi-threaded decode of a buffer: split it at line boundaries, tokenize
+// the chunks in parallel, then feed their entries and boundaries to one
+// ChainBuilder in order. Indentation width, depth and the chain depend on
+// earlier lines, so only that cheap pass is sequential.
+static Manifest parseChunks(std::string_view data, unsigned workers) {
+    // A few chunks per worker, handed out dynamically, even out their cost.
+    const size_t target = data.size() / (size_t{workers} * 4);
+    std::vector<size_t> starts{0};
+    for (size_t at = target; at < data.size(); at = std::max(at, starts.back()) + target) {
+        const void *nl = std::memchr(data.data() + at, '\n', data.size() - at);
+        if (!nl)
+            break;
+        size_t start = static_cast<size_t>(static_cast<const char *>(nl) - data.data()) + 1;
+        if (start >= data.size())
+            break;
+        starts.push_back(start);
+    }
+    starts.push_back(data.size());
+    const size_t n = starts.size() - 1;
+
+    auto chunk_view = [&](size_t i) {
+        return data.substr(starts[i], starts[i + 1] - starts[i]);
+    };
+
+    // Lines before each chunk, so errors carry the same line numbers as
+    // a single-threaded parse.
+    std::vector<int> first_line(n + 1, 0);
+    c4::detail::ParallelFor(n, workers, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            auto view = chunk_view(i);
+            first_line[i + 1] = static_cast<int>(std::count(view.begin(), view.end(), '\n'));
+        }
+    });
+    for (size_t i = 0; i < n; i++)
+        first_line[i + 1] += first_line[i];
+
+    std::vector<ParsedChunk> chunks(n);
+    c4::detail::ParallelFor(n, workers, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            parseChunk(chunk_view(i), first_line[i], chunks[i]);
+    });
+
+    ChainBuilder chain;
+    for (auto &chunk : chunks) {
+        size_t next = 0;
+        auto add_until = [&](size_t end) {
+            for (; next < end; next++)
+                chain.Add(std::move(chunk.entries[next]), chunk.indents[next], {});
+        };
+        for (const auto &b : chunk.boundaries) {
+            add_until(b.entries);
+            chain.Boundary(b.id, b.line_num);
+        }
+        add_until(chunk.entries.size());
+        if (chunk.error)
+            std::rethrow_exception(chunk.error);
+        chunk = ParsedChunk{};
+    }
+    return chain.Finish();
+}
+
+Manifest Manifest::Parse(std::string_view data, unsigned threads) {
+    // Below this much input per worker, threads cost more than they save.
+    constexpr size_t kMinChunk = 1 << 20;
+    unsigned workers = c4::detail::WorkerCount(threads, data.size() / kMinChunk);
+    if (workers > 1)
+        return parseChunks(data, workers);
+    BufferLines lines(data);
+    return parseLines(lines);
+}
+
 Manifest Manifest::Parse(std::istream &stream) {
-    Manifest m;
+    StreamLines lines(stream);
+    return parseLines(lines);
+}
+
+Manifest Manifest::ParseFile(const std::filesystem::path &path, unsigned threads) {
+#ifndef _WIN32
+    MappedFile mapped(path);
+    if (mapped.Mapped())
+        return Parse(mapped.View(), threads);
+#endif
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open())
+        throw std::runtime_error("cannot open file: " + path.string());
+    return Parse(f);
+}
+
+// ----------------------------------------------------------------------
+// ManifestReader
+// ----------------------------------------------------------------------
+
+struct ManifestReader::Impl {
+#ifndef _WIN32
+    std::unique_ptr<MappedFile> mapped;
+#endif
+    std::unique_ptr<std::ifstream> file;
+    std::optional<BufferLines> buffer;
+    std::optional<StreamLines> stream;
+
+    IndentTracker indents;
+    // dirs[d] is the path of the directory at depth d that later entries
+    // at depth d + 1 belong to, while open[d] is set. An entry closes the
+    // directories deeper than itself (see Manifest::ensureIndex).
+    std::vector<std::string> dirs;
+    std::vector<bool> open;
+    std::string path;
+
+    c4::ID base;
     int line_num = 0;
-    int indent_width = -1; // auto-detect
-
-    // Chain resolution: entries accumulate in `section` between bare-C4-ID
-    // boundaries. A bare ID resolves as follows (grammar erratum 2026-07-13,
-    // matching Go reference decoder.go):
-    //   - first non-blank line, no entries yet -> external base reference
-    //   - otherwise a checkpoint naming the accumulated manifest state: flush
-    //     the pending section (base append or patch apply), then verify the
-    //     accumulated C4 ID against the checkpoint (reject on mismatch).
-    // A trailing bare ID at EOF is the closing validator (verified above);
-    // consecutive checkpoints re-verify the same state and are accepted.
-    // Verification is skipped once an external base reference is present.
-    std::vector<Entry> section;
+    int entry_line = 0;
     bool first_line = true;
-    bool patch_mode = false;
-
-    std::string line;
-    while (readLine(stream, line, line_num)) {
-        // Trim for classification checks
-        std::string trimmed = line;
-        size_t first_non_space = trimmed.find_first_not_of(' ');
-        if (first_non_space == std::string::npos)
-            trimmed.clear();
-        else
-            trimmed = trimmed.substr(first_non_space);
 
-        // Skip blank lines (do not clear first_line: "first non-blank line").
-        if (trimmed.empty())
-            continue;
+    bool nextLine(std::string_view &line) {
+        return buffer ? buffer->Next(line, line_num) : stream->Next(line, line_num);
+    }
 
-        // Skip inline ID lists (range data lines, not entries or boundaries).
-        if (isInlineIDList(trimmed))
-            continue;
+    void setPath(const Entry &e) {
+        const size_t d = static_cast<size_t>(e.depth);
+        if (open.size() > d + 1)
+            std::fill(open.begin() + static_cast<std::ptrdiff_t>(d) + 1, open.end(), false);
 
-        // Bare C4 ID line: patch boundary (base reference or checkpoint).
-        if (isBareC4ID(trimmed)) {
-            c4::ID id = c4::ID::Parse(trimmed);
+        if (d > 0 && d <= open.size() && open[d - 1])
+            path.assign(dirs[d - 1]).append(e.name);
+        else
+            path.assign(e.name);
 
-            if (first_line && section.empty()) {
-                // First line of stream: external base reference.
-                m.SetBase(id);
-            } else {
-                applyChainSection(m, section, patch_mode);
-                patch_mode = true;
-
-                // A resolving decoder MUST verify checkpoints -- except after
-                // an unresolved external base reference, where the accumulated
-                // state is unknowable here.
-                if (m.Base().IsNil()) {
-                    c4::ID got = m.ComputeC4ID();
-                    if (got != id) {
-                        throw std::runtime_error(
-                            "c4m: patch ID mismatch (line " + std::to_string(line_num) +
-                            "): accumulated " + got.String() + ", checkpoint " + id.String());
-                    }
-                }
+        if (e.IsDir()) {
+            if (dirs.size() <= d) {
+                dirs.resize(d + 1);
+                open.resize(d + 1, false);
             }
-            first_line = false;
-            continue;
+            dirs[d].assign(path);
+            open[d] = true;
         }
+    }
+};
 
-        // Reject directive lines (lines starting with @).
-        // Go reference behavior: directives are not supported.
-        if (trimmed[0] == '@') {
-            throw std::runtime_error("c4m: directives not supported (line " +
-                                     std::to_string(line_num) + "): " + line);
-        }
+ManifestReader::ManifestReader(std::string_view data) : impl_(std::make_unique<Impl>()) {
+    impl_->buffer.emplace(data);
+}
+
+ManifestReader::ManifestReader(std::istream &stream) : impl_(std::make_unique<Impl>()) {
+    impl_->stream.emplace(stream);
+}
 
-        section.push_back(parseEntryFromLine(line, indent_width, line_num));
-        first_line = false;
+ManifestReader::ManifestReader(const std::filesystem::path &path)
+    : impl_(std::make_unique<Impl>()) {
+#ifndef _WIN32
+    auto mapped = std::make_unique<MappedFile>(path);
+    if (mapped->Mapped()) {
+        impl_->buffer.emplace(mapped->View());
+        impl_->mapped = std::move(mapped);
+        return;
     }
+#endif
+    impl_->file = std::make_unique<std::ifstream>(path, std::ios::binary);
+    if (!impl_->file->is_open())
+        throw std::runtime_error("cannot open file: " + path.string());
+    impl_->stream.emplace(*impl_->file);
+}
 
-    // Flush the trailing section. A stream may end without a closing validator
-    // (final patch applies unverified, C4M-STANDARD 10.7); a stream ending in a
-    // bare C4 ID already flushed an empty section and verified above.
-    applyChainSection(m, section, patch_mode);
+ManifestReader::~ManifestReader() = default;
+ManifestReader::ManifestReader(ManifestReader &&other) noexcept = default;
+ManifestReader &ManifestReader::operator=(ManifestReader &&other) noexcept = default;
+
+bool ManifestReader::Next(Entry &entry) {
+    Impl &r = *impl_;
+    std::string_view line;
+    size_t indent = 0;
 
-    return m;
+    while (r.nextLine(line)) {
+        switch (classifyLine(line, r.line_num, indent)) {
+        case LineKind::Skip:
+            break;
+        case LineKind::Boundary: {
+            // Only the first-line base reference is kept; checkpoints are
+            // checked for well-formedness but not verified.
+            c4::ID id = c4::ID::Parse(line.substr(indent));
+            if (r.first_line)
+                r.base = id;
+            r.first_line = false;
+            break;
+        }
+        case LineKind::Entry:
+            parseEntry(line, indent, r.line_num, entry);
+            entry.depth = r.indents.Depth(indent);
+            r.setPath(entry);
+            r.entry_line = r.line_num;
+            r.first_line = false;
+            return true;
+        }
+    }
+    return false;
 }
 
+const std::string &ManifestReader::Path() const { return impl_->path; }
+
+int ManifestReader::LineNumber() const { return impl_->entry_line; }
+
+const c4::ID &ManifestReader::Base() const { return impl_->base; }
+
 } // namespace c4m
@@ -5,6 +5,7 @@
 #include "c4/c4m.hpp"
 
 #include <string>
+#include <string_view>
 
 namespace {
 
@@ -20,7 +21,7 @@ bool isPrintableRune(uint32_t cp) {
 
 // Decode one UTF-8 rune from s starting at pos.
 // Returns the codepoint and advances pos. On error, returns 0xFFFD and advances by 1.
-uint32_t decodeUTF8(const std::string &s, size_t &pos) {
+uint32_t decodeUTF8(std::string_view s, size_t &pos) {
     uint8_t b0 = static_cast<uint8_t>(s[pos]);
     if (b0 < 0x80) {
         pos++;
@@ -181,11 +182,12 @@ std::string SafeName(const std::string &raw) {
     return out;
 }
 
-std::string UnsafeName(const std::string &encoded) {
-    if (encoded.find('\\') == std::string::npos && encoded.find('\xC2') == std::string::npos) {
+std::string UnsafeName(std::string_view encoded) {
+    if (encoded.find('\\') == std::string_view::npos &&
+        encoded.find('\xC2') == std::string_view::npos) {
         // Quick check: currency sign in UTF-8 is C2 A4; if no backslash and no 0xC2
         // byte, no encoding present.
-        return encoded;
+        return std::string(encoded);
     }
 
     std::string out;
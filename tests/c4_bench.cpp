@@ -1,14 +1,30 @@
 // SPDX-License-Identifier: Apache-2.0
-// Simple benchmark test: hashes 10,000 small strings, encodes/decodes IDs,
-// and builds a tree. Reports timing to verify optimizations don't regress.
+// Simple benchmark test: hashes 10,000 small strings (singly and batched),
+// compares file I/O strategies, encodes/decodes IDs, and builds trees
+// serially and in parallel. Reports timing to verify optimizations don't regress.
 
 #include "c4/c4.hpp"
+#include "c4/c4m.hpp"
+#include "c4/idfilter.hpp"
+#include "c4/idlist.hpp"
+#include "c4/idset.hpp"
+#include "c4/prefixindex.hpp"
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -19,6 +35,119 @@ double elapsed_ms(Clock::time_point start, Clock::time_point end) {
     return std::chrono::duration<double, std::milli>(end - start).count();
 }
 
+// Set of n IDs with pseudo-random digests (hashing inputs would dominate
+// the setup time for the large sizes).
+c4::IDs random_ids(size_t n) {
+    c4::IDs set;
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    uint8_t digest[c4::DigestLen];
+    for (size_t i = 0; i < n; i++) {
+        for (size_t w = 0; w < c4::DigestLen; w += 8) {
+            x += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = x;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z ^= z >> 31;
+            std::memcpy(digest + w, &z, 8);
+        }
+        set.Append(c4::ID::FromDigest(digest, c4::DigestLen));
+    }
+    return set;
+}
+
+void bench_tree_scaling(size_t n) {
+    auto set = random_ids(n);
+
+    auto start = Clock::now();
+    auto serial = set.TreeID();
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  TreeID, %zu IDs: %.2f ms\n", n, ms);
+
+    for (unsigned threads : {2u, 4u, 8u}) {
+        start = Clock::now();
+        auto parallel = set.ParallelTreeID(threads);
+        ms = elapsed_ms(start, Clock::now());
+        std::printf("  ParallelTreeID, %zu IDs, %u threads: %.2f ms\n", n, threads, ms);
+        REQUIRE(parallel == serial);
+    }
+}
+
+// Build an IDFilter of n pseudo-random IDs and query n members and n
+// non-members. IDs are generated on the fly, so no ID set is held in
+// memory even at 100M.
+void bench_filter(size_t n) {
+    auto make = [](uint64_t i) {
+        uint8_t digest[c4::DigestLen];
+        uint64_t x = i * 0x9e3779b97f4a7c15ULL;
+        for (size_t w = 0; w < c4::DigestLen; w += 8) {
+            x += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = x;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z ^= z >> 31;
+            std::memcpy(digest + w, &z, 8);
+        }
+        return c4::ID::FromDigest(digest, c4::DigestLen);
+    };
+
+    auto start = Clock::now();
+    c4::IDFilter filter(n);
+    for (size_t i = 0; i < n; i++)
+        filter.Add(make(i));
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  IDFilter build, %zu IDs: %.2f ms (%.1f ns/ID, %.1f MiB)\n", n, ms,
+                ms * 1e6 / static_cast<double>(n), static_cast<double>(filter.Bytes()) / (1 << 20));
+
+    size_t hits = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < n; i++)
+        hits += filter.MayContain(make(i));
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  IDFilter query, members: %.2f ms (%.1f ns/op)\n", ms,
+                ms * 1e6 / static_cast<double>(n));
+    REQUIRE(hits == n);
+
+    hits = 0;
+    start = Clock::now();
+    for (size_t i = n; i < 2 * n; i++)
+        hits += filter.MayContain(make(i));
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  IDFilter query, non-members: %.2f ms (%.1f ns/op, %.3f%% false positives)\n",
+                ms, ms * 1e6 / static_cast<double>(n), 100.0 * static_cast<double>(hits) / static_cast<double>(n));
+
+    // Batched queries, members and non-members alternating in batches.
+    constexpr size_t kBatch = 4096;
+    std::vector<c4::ID> batch(kBatch);
+    std::unique_ptr<bool[]> found(new bool[kBatch]);
+    hits = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < 2 * n; i += kBatch) {
+        size_t m = std::min(kBatch, 2 * n - i);
+        for (size_t j = 0; j < m; j++)
+            batch[j] = make(i + j);
+        filter.MayContainMany(batch.data(), m, found.get());
+        for (size_t j = 0; j < m; j++)
+            hits += found[j];
+    }
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  IDFilter MayContainMany, all: %.2f ms (%.1f ns/op)\n", ms,
+                ms * 1e6 / static_cast<double>(2 * n));
+    REQUIRE(hits >= n);
+}
+
+// Text of a manifest with n files spread over directories of 100 files.
+std::string synthetic_manifest(size_t n) {
+    std::string text;
+    auto ids = random_ids(n);
+    for (size_t i = 0; i < n; i++) {
+        if (i % 100 == 0)
+            text += "drwxr-xr-x 2024-01-01T00:00:00Z 4096 dir" + std::to_string(i / 100) + "/ -\n";
+        text += "  -rw-r--r-- 2024-01-01T00:00:00Z " + std::to_string(i * 37 % 100000) + " file" +
+                std::to_string(i % 100) + ".dat " + ids[i].String() + "\n";
+    }
+    return text;
+}
+
 } // anonymous namespace
 
 TEST_CASE("Bench: hash 10000 small strings", "[bench]") {
@@ -43,6 +172,106 @@ TEST_CASE("Bench: hash 10000 small strings", "[bench]") {
     REQUIRE(ids[0] != ids[1]);
 }
 
+TEST_CASE("Bench: batch vs single identify of 10000 small inputs", "[bench]") {
+    constexpr int N = 10000;
+    std::vector<std::string> inputs;
+    inputs.reserve(N);
+    for (int i = 0; i < N; i++) {
+        inputs.push_back("batch-input-" + std::to_string(i) + std::string(i % 512, 'x'));
+    }
+    std::vector<std::string_view> views(inputs.begin(), inputs.end());
+
+    std::vector<c4::ID> single(N);
+    auto start = Clock::now();
+    for (int i = 0; i < N; i++) {
+        single[i] = c4::ID::Identify(views[i]);
+    }
+    auto mid = Clock::now();
+    std::vector<c4::ID> batch(N);
+    c4::ID::IdentifyBatch(views.data(), views.size(), batch.data());
+    auto end = Clock::now();
+
+    double single_ms = elapsed_ms(start, mid);
+    double batch_ms = elapsed_ms(mid, end);
+    std::printf("  Identify %d inputs: %.2f ms (%.0f ns/op)\n",
+                N, single_ms, single_ms * 1e6 / N);
+    std::printf("  IdentifyBatch %d inputs: %.2f ms (%.0f ns/op)\n",
+                N, batch_ms, batch_ms * 1e6 / N);
+
+    REQUIRE(single == batch);
+}
+
+TEST_CASE("Bench: IdentifyFile I/O strategies on a 64 MiB file", "[bench]") {
+    constexpr size_t Size = 64u << 20;
+    auto path = std::filesystem::temp_directory_path() / "c4_bench_io.bin";
+    {
+        std::string block(1 << 20, '\0');
+        for (size_t i = 0; i < block.size(); i++)
+            block[i] = static_cast<char>(i * 131);
+        std::ofstream f(path, std::ios::binary);
+        for (size_t i = 0; i < Size / block.size(); i++)
+            f.write(block.data(), static_cast<std::streamsize>(block.size()));
+    }
+
+    const std::pair<const char *, c4::IOStrategy> strategies[] = {
+        {"stream", c4::IOStrategy::Stream}, {"mmap", c4::IOStrategy::Mmap},
+        {"pread", c4::IOStrategy::Pread},   {"direct", c4::IOStrategy::Direct},
+        {"auto", c4::IOStrategy::Auto},
+    };
+    c4::ID first;
+    for (const auto &[name, io] : strategies) {
+        c4::IdentifyOptions opts;
+        opts.io = io;
+        auto start = Clock::now();
+        auto id = c4::ID::IdentifyFile(path, opts);
+        auto end = Clock::now();
+        double ms = elapsed_ms(start, end);
+        std::printf("  IdentifyFile 64 MiB (%s): %.2f ms (%.0f MB/s)\n",
+                    name, ms, Size / 1e3 / ms);
+        if (first.IsNil())
+            first = id;
+        REQUIRE(id == first);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Bench: IdentifyFiles thread scaling on a synthetic tree", "[bench]") {
+    // 2000 small files across 20 directories.
+    auto root = std::filesystem::temp_directory_path() / "c4_bench_tree";
+    std::filesystem::remove_all(root);
+    std::vector<std::filesystem::path> paths;
+    for (int d = 0; d < 20; d++) {
+        auto dir = root / ("d" + std::to_string(d));
+        std::filesystem::create_directories(dir);
+        for (int f = 0; f < 100; f++) {
+            auto path = dir / ("f" + std::to_string(f));
+            std::ofstream(path, std::ios::binary)
+                << std::string(static_cast<size_t>(512 + (f * 61) % 8192), 'a' + d % 26);
+            paths.push_back(path);
+        }
+    }
+
+    auto start = Clock::now();
+    std::vector<c4::ID> serial;
+    serial.reserve(paths.size());
+    for (const auto &p : paths)
+        serial.push_back(c4::ID::IdentifyFile(p));
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  IdentifyFile loop, %zu files: %.2f ms\n", paths.size(), ms);
+
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        c4::IdentifyOptions opts;
+        opts.threads = threads;
+        start = Clock::now();
+        auto ids = c4::IdentifyFiles(paths, opts);
+        ms = elapsed_ms(start, Clock::now());
+        std::printf("  IdentifyFiles, %zu files, %u threads: %.2f ms\n",
+                    paths.size(), threads, ms);
+        REQUIRE(ids == serial);
+    }
+    std::filesystem::remove_all(root);
+}
+
 TEST_CASE("Bench: encode 10000 IDs to string", "[bench]") {
     constexpr int N = 10000;
     std::vector<c4::ID> ids;
@@ -83,6 +312,79 @@ TEST_CASE("Bench: decode 10000 ID strings", "[bench]") {
                 N, ms, ms * 1e6 / N);
 }
 
+TEST_CASE("Bench: batch encode and parse of 10000 IDs", "[bench]") {
+    constexpr int N = 10000;
+    std::vector<c4::ID> ids;
+    ids.reserve(N);
+    for (int i = 0; i < N; i++) {
+        ids.push_back(c4::ID::Identify("encode-bench-" + std::to_string(i)));
+    }
+    std::string text(N * c4::IDLen, '\0');
+
+    auto start = Clock::now();
+    c4::EncodeIDs(ids.data(), N, text.data());
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  EncodeIDs %d IDs: %.2f ms (%.0f ns/op)\n", N, ms, ms * 1e6 / N);
+
+    std::vector<c4::ID> parsed(N);
+    start = Clock::now();
+    c4::ParseIDs(text.data(), N, parsed.data());
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  ParseIDs %d IDs: %.2f ms (%.0f ns/op)\n", N, ms, ms * 1e6 / N);
+
+    REQUIRE(parsed == ids);
+}
+
+TEST_CASE("Bench: parse 10000 candidates that are 90% invalid", "[bench]") {
+    constexpr int N = 10000;
+    std::vector<std::string> strs;
+    strs.reserve(N);
+    int valid = 0;
+    for (int i = 0; i < N; i++) {
+        auto s = c4::ID::Identify("mixed-bench-" + std::to_string(i)).String();
+        switch (i % 10) {
+        case 0: valid++; break;
+        case 1: case 2: case 3: s.resize(40 + i % 40); break;  // truncated
+        case 4: case 5: s[0] = 'C'; break;                     // not an ID
+        case 6: case 7: s[10 + i % 80] = 'l'; break;           // bad digit
+        default: s = "c4" + std::string(88, 'z'); break;       // overflow
+        }
+        strs.push_back(std::move(s));
+    }
+
+    int ok = 0;
+    auto start = Clock::now();
+    for (const auto &s : strs) {
+        try {
+            c4::ID::Parse(s);
+            ok++;
+        } catch (const std::invalid_argument &) {
+        }
+    }
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  Parse with catch: %.2f ms (%.0f ns/op)\n", ms, ms * 1e6 / N);
+    REQUIRE(ok == valid);
+
+    ok = 0;
+    c4::ID id;
+    start = Clock::now();
+    for (const auto &s : strs) {
+        ok += c4::ID::TryParse(s, id) == c4::ParseStatus::Ok;
+    }
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  TryParse: %.2f ms (%.0f ns/op)\n", ms, ms * 1e6 / N);
+    REQUIRE(ok == valid);
+
+    ok = 0;
+    start = Clock::now();
+    for (const auto &s : strs) {
+        ok += c4::IsValidIDString(s);
+    }
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  IsValidIDString: %.2f ms (%.0f ns/op)\n", ms, ms * 1e6 / N);
+    REQUIRE(ok == valid);
+}
+
 TEST_CASE("Bench: tree of 1000 IDs", "[bench]") {
     constexpr int N = 1000;
     c4::IDs set;
@@ -100,6 +402,115 @@ TEST_CASE("Bench: tree of 1000 IDs", "[bench]") {
     REQUIRE_FALSE(tree.IsNil());
 }
 
+TEST_CASE("Bench: TreeID scaling from 1K to 1M IDs", "[bench]") {
+    for (size_t n : {size_t{1000}, size_t{10000}, size_t{100000}, size_t{1000000}})
+        bench_tree_scaling(n);
+}
+
+// Large sets need several GiB of memory; run explicitly with
+// c4_bench "[tree-large]".
+TEST_CASE("Bench: TreeID scaling at 10M and 100M IDs", "[.][bench][tree-large]") {
+    for (size_t n : {size_t{10000000}, size_t{100000000}})
+        bench_tree_scaling(n);
+}
+
+TEST_CASE("Bench: TreeID of 1000000 IDs unsorted vs sorted vs consumed", "[bench]") {
+    auto ids = random_ids(1000000);
+
+    auto start = Clock::now();
+    auto expected = ids.TreeID();
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  TreeID, unsorted (sorted copy): %.2f ms\n", ms);
+
+    auto sorted = ids;
+    sorted.SortUnique();
+    start = Clock::now();
+    REQUIRE(sorted.TreeID() == expected);
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  TreeID, SortUnique() set (in place): %.2f ms\n", ms);
+
+    start = Clock::now();
+    REQUIRE(std::move(ids).TreeID() == expected);
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  TreeID() &&, unsorted (sorts in place): %.2f ms\n", ms);
+}
+
+TEST_CASE("Bench: TreeBuilder streaming 1000000 sorted IDs", "[bench]") {
+    auto set = random_ids(1000000);
+    std::vector<c4::ID> sorted(set.begin(), set.end());
+    std::sort(sorted.begin(), sorted.end());
+
+    auto start = Clock::now();
+    c4::TreeBuilder builder;
+    for (const auto &id : sorted)
+        builder.Add(id);
+    auto tree = builder.Finalize();
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  TreeBuilder, %zu IDs: %.2f ms\n", sorted.size(), ms);
+
+    REQUIRE(tree == set.TreeID());
+}
+
+TEST_CASE("Bench: IncrementalIDs with 100-ID deltas on 1000000 IDs", "[bench]") {
+    auto set = random_ids(1000000);
+    auto extra = random_ids(1000100);  // same generator: the tail is new IDs
+
+    auto start = Clock::now();
+    c4::IncrementalIDs inc(set);
+    auto tree = inc.TreeID();
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  IncrementalIDs initial build, %zu IDs: %.2f ms\n", set.Size(), ms);
+    REQUIRE(tree == set.TreeID());
+
+    // Each round: 100 inserts scattered across the set, then the same 100
+    // removed again.
+    constexpr int kRounds = 5;
+    double insert_ms = 0, remove_ms = 0;
+    for (int round = 0; round < kRounds; round++) {
+        for (size_t i = 0; i < 100; i++)
+            inc.Insert(extra[set.Size() + (round * 20 + i) % 100]);
+        start = Clock::now();
+        tree = inc.TreeID();
+        insert_ms += elapsed_ms(start, Clock::now());
+
+        for (size_t i = 0; i < 100; i++)
+            inc.Remove(extra[set.Size() + (round * 20 + i) % 100]);
+        start = Clock::now();
+        tree = inc.TreeID();
+        remove_ms += elapsed_ms(start, Clock::now());
+    }
+    std::printf("  IncrementalIDs +100 IDs: %.2f ms, -100 IDs: %.2f ms\n",
+                insert_ms / kRounds, remove_ms / kRounds);
+
+    start = Clock::now();
+    auto full = set.TreeID();
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  IDs::TreeID full rebuild: %.2f ms\n", ms);
+    REQUIRE(tree == full);
+}
+
+TEST_CASE("Bench: inclusion proofs on 1000000 IDs", "[bench]") {
+    auto set = random_ids(1000000);
+    c4::IncrementalIDs tree(set);
+    auto root = tree.TreeID();
+
+    constexpr size_t kProofs = 10000;
+    std::vector<c4::InclusionProof> proofs;
+    proofs.reserve(kProofs);
+    auto start = Clock::now();
+    for (size_t i = 0; i < kProofs; i++)
+        proofs.push_back(tree.Proof(set[i * 97]));
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  Proof from cached levels: %.0f ns/op (%zu siblings)\n",
+                ms * 1e6 / kProofs, proofs[0].siblings.size());
+
+    start = Clock::now();
+    for (size_t i = 0; i < kProofs; i++)
+        REQUIRE(c4::VerifyInclusion(set[i * 97], proofs[i], root));
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  VerifyInclusion: %.0f ns/op\n", ms * 1e6 / kProofs);
+}
+
 TEST_CASE("Bench: Sum 10000 pairs", "[bench]") {
     constexpr int N = 10000;
     std::vector<c4::ID> ids;
@@ -119,3 +530,273 @@ TEST_CASE("Bench: Sum 10000 pairs", "[bench]") {
     std::printf("  Sum %d pairs: %.2f ms (%.0f ns/op)\n",
                 N - 1, ms, ms * 1e6 / (N - 1));
 }
+
+TEST_CASE("Bench: SumPairs 10000 pairs", "[bench]") {
+    constexpr int N = 10000;
+    std::vector<c4::ID> ids;
+    ids.reserve(N);
+    for (int i = 0; i < N; i++) {
+        ids.push_back(c4::ID::Identify("sum-bench-" + std::to_string(i)));
+    }
+    std::vector<c4::ID> out(N - 1);
+
+    auto start = Clock::now();
+    c4::ID::SumPairs(ids.data(), ids.data() + 1, out.data(), N - 1);
+    auto end = Clock::now();
+
+    double ms = elapsed_ms(start, end);
+    std::printf("  SumPairs %d pairs: %.2f ms (%.0f ns/op)\n",
+                N - 1, ms, ms * 1e6 / (N - 1));
+    REQUIRE(out[0] == ids[0].Sum(ids[1]));
+}
+
+TEST_CASE("Bench: IDSet vs unordered_set on 1000000 IDs", "[bench]") {
+    constexpr size_t N = 1000000;
+    auto ids = random_ids(2 * N);  // first half inserted, second half misses
+
+    std::unordered_set<c4::ID> std_set;
+    auto start = Clock::now();
+    for (size_t i = 0; i < N; i++)
+        std_set.insert(ids[i]);
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  unordered_set insert: %.2f ms (%.0f ns/op)\n", ms, ms * 1e6 / N);
+
+    size_t hits = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < 2 * N; i++)
+        hits += std_set.count(ids[i]);
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  unordered_set lookup (50%% hits): %.2f ms (%.0f ns/op)\n", ms, ms * 5e5 / N);
+    REQUIRE(hits == N);
+
+    c4::IDSet set;
+    start = Clock::now();
+    for (size_t i = 0; i < N; i++)
+        set.Insert(ids[i]);
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  IDSet insert: %.2f ms (%.0f ns/op)\n", ms, ms * 1e6 / N);
+
+    hits = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < 2 * N; i++)
+        hits += set.Contains(ids[i]);
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  IDSet lookup (50%% hits): %.2f ms (%.0f ns/op)\n", ms, ms * 5e5 / N);
+    REQUIRE(hits == N);
+}
+
+TEST_CASE("Bench: IDList open and lookups on 1000000 IDs", "[bench]") {
+    constexpr size_t N = 1000000;
+    auto ids = random_ids(N);
+    auto path = std::filesystem::temp_directory_path() / "c4_bench_idlist.bin";
+
+    auto start = Clock::now();
+    c4::IDList::Write(path, ids);
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  Write (sort included): %.2f ms\n", ms);
+
+    std::string text(N * c4::IDLen, '\0');
+    c4::EncodeIDs(&ids[0], N, text.data());
+    std::vector<c4::ID> parsed(N);
+    start = Clock::now();
+    c4::ParseIDs(text.data(), N, parsed.data());
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  Load as text (ParseIDs): %.2f ms\n", ms);
+
+    start = Clock::now();
+    auto list = c4::IDList::Open(path);
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  Open: %.3f ms\n", ms);
+
+    size_t hits = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < N; i++)
+        hits += list.Contains(ids[i]);
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  Contains: %.2f ms (%.0f ns/op)\n", ms, ms * 1e6 / N);
+    REQUIRE(hits == N);
+
+    start = Clock::now();
+    REQUIRE(list.TreeID() == ids.TreeID());
+    std::printf("  TreeID from mapping + from IDs: %.2f ms\n", elapsed_ms(start, Clock::now()));
+
+    list = c4::IDList();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Bench: IDFilter build and query on 1000000 IDs", "[bench]") {
+    bench_filter(1000000);
+}
+
+TEST_CASE("Bench: IDFilter build and query on 100000000 IDs", "[.][bench][filter-large]") {
+    bench_filter(100000000);
+}
+
+TEST_CASE("Bench: PrefixIndex resolve on 1000000 IDs", "[bench]") {
+    constexpr size_t N = 1000000;
+    constexpr size_t Q = 100000;
+    auto ids = random_ids(N);
+    std::vector<std::string> prefixes;
+    for (size_t i = 0; i < Q; i++)
+        prefixes.push_back(ids[i * (N / Q)].String().substr(0, 12));
+
+    auto start = Clock::now();
+    c4::PrefixIndex index(ids);
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  Build: %.2f ms\n", ms);
+
+    size_t unique = 0;
+    start = Clock::now();
+    for (const auto &p : prefixes)
+        unique += index.Resolve(p).match == c4::PrefixMatch::Unique;
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  Resolve 12-char prefixes: %.2f ms (%.0f ns/op)\n", ms, ms * 1e6 / Q);
+    REQUIRE(unique == Q);
+
+    // What resolving one prefix used to cost: encode and compare every ID.
+    size_t matches = 0;
+    start = Clock::now();
+    for (const auto &id : ids)
+        matches += id.String().compare(0, 12, prefixes[0]) == 0;
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  Linear scan with String(), one prefix: %.2f ms\n", ms);
+    REQUIRE(matches == 1);
+}
+
+TEST_CASE("Bench: c4m parse of 200000 entries from buffer stream and file", "[bench]") {
+    auto text = synthetic_manifest(200000);
+    auto path = std::filesystem::temp_directory_path() / "c4_bench_parse.c4m";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << text;
+    }
+
+    auto start = Clock::now();
+    auto from_buffer = c4m::Manifest::Parse(std::string_view(text));
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  Parse(string_view), %.1f MiB: %.2f ms\n",
+                static_cast<double>(text.size()) / (1 << 20), ms);
+
+    std::istringstream in(text);
+    start = Clock::now();
+    auto from_stream = c4m::Manifest::Parse(in);
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  Parse(istream): %.2f ms\n", ms);
+
+    start = Clock::now();
+    auto from_file = c4m::Manifest::ParseFile(path);
+    ms = elapsed_ms(start, Clock::now());
+    std::printf("  ParseFile (mmap): %.2f ms\n", ms);
+
+    REQUIRE(from_buffer.EntryCount() == 202000);
+    REQUIRE(from_stream.EntryCount() == from_buffer.EntryCount());
+    REQUIRE(from_file.EntryCount() == from_buffer.EntryCount());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Bench: c4m per-line parse of 400000 entries without IDs", "[bench]") {
+    // Null IDs keep ID decoding out of the measurement, so this tracks the
+    // entry tokenizer: plain names, escaped names, sequences and symlinks.
+    constexpr size_t N = 400000;
+    std::string text;
+    for (size_t i = 0; i < N; i++) {
+        auto n = std::to_string(i);
+        switch (i % 4) {
+        case 0:
+            text += "-rw-r--r-- 2024-01-01T00:00:00Z 1,024 file" + n + ".dat -\n";
+            break;
+        case 1:
+            text += "-rw-r--r-- 2024-01-01T00:00:00Z 2048 my\\ file\\ " + n + ".txt -\n";
+            break;
+        case 2:
+            text += "-rw-r--r-- 2024-01-01T00:00:00Z 4096 shot" + n + ".[0001-0100].exr -\n";
+            break;
+        default:
+            text += "lrwxrwxrwx 2024-01-01T00:00:00Z 0 link" + n + " -> target" + n + " -\n";
+            break;
+        }
+    }
+
+    auto start = Clock::now();
+    auto m = c4m::Manifest::Parse(std::string_view(text));
+    double ms = elapsed_ms(start, Clock::now());
+    std::printf("  Parse %zu lines: %.2f ms (%.0f ns/line)\n", N, ms, ms * 1e6 / N);
+
+    REQUIRE(m.EntryCount() == N);
+}
+
+TEST_CASE("Bench: c4m timestamp parse and format of 1000000 values", "[bench]") {
+    // Ten timestamps per day, as in a manifest of files written together.
+    constexpr int N = 1000000;
+    std::vector<std::string> text;
+    text.reserve(N);
+    for (int i = 0; i < N; i++)
+        text.push_back(c4m::FormatTimestamp(1704067200 + (i / 10) * 86400 + i % 10 * 61));
+
+    int64_t sum = 0;
+    auto start = Clock::now();
+    for (const auto &s : text)
+        sum += c4m::ParseTimestamp(s);
+    double parse_ms = elapsed_ms(start, Clock::now());
+
+    size_t len = 0;
+    start = Clock::now();
+    for (int i = 0; i < N; i++)
+        len += c4m::FormatTimestamp(1704067200 + (i / 10) * 86400 + i % 10 * 61).size();
+    double format_ms = elapsed_ms(start, Clock::now());
+
+    std::printf("  ParseTimestamp: %.2f ms (%.0f ns/op)\n", parse_ms, parse_ms * 1e6 / N);
+    std::printf("  FormatTimestamp: %.2f ms (%.0f ns/op)\n", format_ms, format_ms * 1e6 / N);
+
+    REQUIRE(sum != 0);
+    REQUIRE(len == static_cast<size_t>(N) * 20);
+}
+
+TEST_CASE("Bench: c4m parallel parse of 500000 entries", "[bench]") {
+    auto text = synthetic_manifest(500000);
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto start = Clock::now();
+    auto serial = c4m::Manifest::Parse(std::string_view(text));
+    double serial_ms = elapsed_ms(start, Clock::now());
+
+    start = Clock::now();
+    auto parallel = c4m::Manifest::Parse(std::string_view(text), 0);
+    double parallel_ms = elapsed_ms(start, Clock::now());
+
+    std::printf("  Parse, %.1f MiB, 1 thread: %.2f ms\n",
+                static_cast<double>(text.size()) / (1 << 20), serial_ms);
+    std::printf("  Parse, %u threads: %.2f ms (%.2fx)\n", threads, parallel_ms,
+                serial_ms / parallel_ms);
+
+    REQUIRE(parallel.EntryCount() == serial.EntryCount());
+}
+
+TEST_CASE("Bench: ManifestReader vs Parse summing sizes of 500000 entries", "[bench]") {
+    auto text = synthetic_manifest(500000);
+
+    auto start = Clock::now();
+    auto m = c4m::Manifest::Parse(std::string_view(text));
+    int64_t parse_total = 0;
+    for (const auto &e : m.Entries())
+        parse_total += e.size;
+    double parse_ms = elapsed_ms(start, Clock::now());
+
+    start = Clock::now();
+    c4m::ManifestReader reader{std::string_view(text)};
+    c4m::Entry e;
+    int64_t reader_total = 0;
+    size_t count = 0;
+    while (reader.Next(e)) {
+        reader_total += e.size;
+        count++;
+    }
+    double reader_ms = elapsed_ms(start, Clock::now());
+
+    std::printf("  Parse + sum: %.2f ms\n", parse_ms);
+    std::printf("  ManifestReader + sum: %.2f ms (%.0f ns/entry, one reused Entry)\n",
+                reader_ms, reader_ms * 1e6 / count);
+
+    REQUIRE(count == m.EntryCount());
+    REQUIRE(reader_total == parse_total);
+}
@@ -1,13 +1,30 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "c4/c4.hpp"
 #include "c4/c4.h"
+#include "c4/idfilter.hpp"
+#include "c4/idlist.hpp"
+#include "c4/idset.hpp"
+#include "c4/prefixindex.hpp"
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 // =============================================================
 // Test vectors from the Go reference implementation.
@@ -92,6 +109,57 @@ TEST_CASE("C4 ID: parse rejects invalid prefix", "[c4][id]") {
     REQUIRE_THROWS_AS(c4::ID::Parse(bad), std::invalid_argument);
 }
 
+TEST_CASE("C4 ID: TryParse reports why a string is not an ID", "[c4][id]") {
+    auto good = c4::ID::Identify("try");
+    auto str = good.String();
+    c4::ID out;
+    REQUIRE(c4::ID::TryParse(str, out) == c4::ParseStatus::Ok);
+    REQUIRE(out == good);
+    REQUIRE(c4::IsValidIDString(str));
+
+    auto bad_digit = str;
+    bad_digit[40] = '0';
+    auto bad_prefix = str;
+    bad_prefix[1] = '5';
+    auto overflow = "c4" + std::string(88, 'z');
+
+    struct Case { std::string text; c4::ParseStatus status; };
+    for (const auto &c : {Case{"", c4::ParseStatus::BadLength},
+                          Case{str + "1", c4::ParseStatus::BadLength},
+                          Case{bad_prefix, c4::ParseStatus::BadPrefix},
+                          Case{bad_digit, c4::ParseStatus::BadDigit},
+                          Case{overflow, c4::ParseStatus::Overflow}}) {
+        c4::ID untouched = good;
+        REQUIRE(c4::ID::TryParse(c.text, untouched) == c.status);
+        REQUIRE(untouched == good);
+        REQUIRE_FALSE(c4::IsValidIDString(c.text));
+        REQUIRE_THROWS_AS(c4::ID::Parse(c.text), std::invalid_argument);
+    }
+}
+
+TEST_CASE("C4 ID: _c4id literals decode at compile time", "[c4][id]") {
+    using namespace c4::literals;
+    constexpr auto empty =
+        "c459dsjfscH38cYeXXYogktxf4Cd9ibshE3BHUo6a58hBXmRQdZrAkZzsWcbWtDg5oQstpDuni4Hirj75GEmTc1sFT"_c4id;
+    constexpr auto zero =
+        "c41111111111111111111111111111111111111111111111111111111111111111111111111111111111111111"_c4id;
+    constexpr auto max =
+        "c467rpwLCuS5DGA8KGZXKsVQ7dnPb9goRLoKfgGbLfQg9WoLUgNY77E2jT11fem3coV9nAkguBACzrU1iyZM4B8roQ"_c4id;
+    static_assert(zero.Digest()[0] == 0 && zero.Digest()[63] == 0);
+    static_assert(max.Digest()[0] == 0xFF && max.Digest()[63] == 0xFF);
+
+    REQUIRE(empty == c4::ID::Identify(""));
+    REQUIRE(zero.IsNil());
+    uint8_t all_ff[64];
+    std::memset(all_ff, 0xFF, 64);
+    REQUIRE(max == c4::ID::FromDigest(all_ff, 64));
+
+    // Outside a constant expression a bad literal throws like Parse.
+    REQUIRE_THROWS_AS("c4short"_c4id, std::invalid_argument);
+    auto overflow = "c4" + std::string(88, 'z');
+    REQUIRE_THROWS_AS(operator""_c4id(overflow.data(), overflow.size()), std::invalid_argument);
+}
+
 // =============================================================
 // Edge case encodings from Go tests
 // =============================================================
@@ -140,6 +208,77 @@ TEST_CASE("C4 ID: specific byte patterns from Go", "[c4][id]") {
     }
 }
 
+TEST_CASE("C4 ID: EncodeTo writes exactly the String() characters", "[c4][id]") {
+    for (int i = 0; i < 200; i++) {
+        auto id = c4::ID::Identify("encode-" + std::to_string(i));
+        char buf[c4::IDLen + 1];
+        buf[c4::IDLen] = '#';
+        id.EncodeTo(buf);
+        REQUIRE(buf[c4::IDLen] == '#');
+        REQUIRE(std::string(buf, c4::IDLen) == id.String());
+        REQUIRE(c4::ID::Parse(std::string_view(buf, c4::IDLen)) == id);
+    }
+}
+
+TEST_CASE("C4 ID: stream output honors width and fill", "[c4][id]") {
+    auto id = c4::ID::Identify("stream");
+    std::ostringstream plain;
+    plain << id;
+    REQUIRE(plain.str() == id.String());
+
+    std::ostringstream padded;
+    padded << std::setw(c4::IDLen + 3) << std::setfill('.') << std::left << id << '|';
+    REQUIRE(padded.str() == id.String() + "...|");
+}
+
+TEST_CASE("C4 ID: EncodeIDs and ParseIDs match the single-ID calls", "[c4][id][batch]") {
+    std::vector<c4::ID> ids;
+    uint8_t zeros[64] = {};
+    uint8_t ones[64];
+    std::memset(ones, 0xFF, sizeof(ones));
+    ids.push_back(c4::ID::FromDigest(zeros, 64));
+    ids.push_back(c4::ID::FromDigest(ones, 64));
+    for (int i = 0; i < 299; i++)
+        ids.push_back(c4::ID::Identify("batch-encode-" + std::to_string(i)));
+
+    std::string text(ids.size() * c4::IDLen, '\0');
+    c4::EncodeIDs(ids.data(), ids.size(), text.data());
+    for (size_t i = 0; i < ids.size(); i++)
+        REQUIRE(text.substr(i * c4::IDLen, c4::IDLen) == ids[i].String());
+
+    std::vector<c4::ID> parsed(ids.size());
+    c4::ParseIDs(text.data(), ids.size(), parsed.data());
+    REQUIRE(parsed == ids);
+}
+
+TEST_CASE("C4 ID: parse rejects every non-alphabet byte at every position", "[c4][id]") {
+    auto good = c4::ID::Identify("alphabet").String();
+    std::string alphabet = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    for (int c = 1; c < 256; c++) {
+        if (alphabet.find(static_cast<char>(c)) != std::string::npos)
+            continue;
+        for (size_t pos : {size_t{2}, size_t{33}, size_t{57}, size_t{60}, size_t{89}}) {
+            auto bad = good;
+            bad[pos] = static_cast<char>(c);
+            REQUIRE_THROWS_AS(c4::ID::Parse(bad), std::invalid_argument);
+
+            std::string batch = good + bad + good + good;
+            std::vector<c4::ID> out(4);
+            REQUIRE_THROWS_AS(c4::ParseIDs(batch.data(), 4, out.data()), std::invalid_argument);
+        }
+    }
+}
+
+TEST_CASE("C4 ID: parse rejects values above 2^512 - 1", "[c4][id]") {
+    // The all-0xFF digest encodes to the largest valid string.
+    std::string max = "c467rpwLCuS5DGA8KGZXKsVQ7dnPb9goRLoKfgGbLfQg9WoLUgNY77E2jT11fem3coV9nAkguBACzrU1iyZM4B8roQ";
+    REQUIRE_NOTHROW(c4::ID::Parse(max));
+    auto above = max;
+    above.back() = 'R';
+    REQUIRE_THROWS_AS(c4::ID::Parse(above), std::invalid_argument);
+    REQUIRE_THROWS_AS(c4::ID::Parse("c4" + std::string(88, 'z')), std::invalid_argument);
+}
+
 // =============================================================
 // FromDigest tests
 // =============================================================
@@ -179,6 +318,38 @@ TEST_CASE("C4 ID: Sum produces a different ID", "[c4][id]") {
     REQUIRE(s != b);
 }
 
+TEST_CASE("C4 ID: Sum is the ID of the sorted concatenated digests", "[c4][id]") {
+    for (int i = 0; i < 64; i++) {
+        auto a = c4::ID::Identify("left " + std::to_string(i));
+        auto b = c4::ID::Identify("right " + std::to_string(i));
+        const auto &lo = a < b ? a : b;
+        const auto &hi = a < b ? b : a;
+        std::string msg(reinterpret_cast<const char *>(lo.Digest().data()), c4::DigestLen);
+        msg.append(reinterpret_cast<const char *>(hi.Digest().data()), c4::DigestLen);
+        REQUIRE(a.Sum(b) == c4::ID::Identify(msg));
+    }
+}
+
+TEST_CASE("C4 ID: SumPairs matches Sum", "[c4][id]") {
+    constexpr size_t N = 37;
+    std::vector<c4::ID> left, right;
+    for (size_t i = 0; i < N; i++) {
+        left.push_back(c4::ID::Identify("l" + std::to_string(i)));
+        // Every fifth pair is equal, which Sum copies instead of hashing
+        right.push_back(i % 5 == 0 ? left.back() : c4::ID::Identify("r" + std::to_string(i)));
+    }
+
+    std::vector<c4::ID> out(N);
+    c4::ID::SumPairs(left.data(), right.data(), out.data(), N);
+    for (size_t i = 0; i < N; i++)
+        REQUIRE(out[i] == left[i].Sum(right[i]));
+
+    // In place over the left operands
+    auto in_place = left;
+    c4::ID::SumPairs(in_place.data(), right.data(), in_place.data(), N);
+    REQUIRE(in_place == out);
+}
+
 // =============================================================
 // Nil / Comparison tests
 // =============================================================
@@ -208,6 +379,60 @@ TEST_CASE("C4 ID: stream identify matches direct", "[c4][id]") {
     REQUIRE(id == direct);
 }
 
+// =============================================================
+// Batch identification
+// =============================================================
+
+TEST_CASE("C4 ID: IdentifyBatch matches Identify", "[c4][id][batch]") {
+    // Lengths straddle the 111/112-byte padding boundary, multi-block inputs
+    // and the large-input passthrough, in mixed order.
+    std::vector<std::string> inputs;
+    for (size_t len = 0; len < 300; len++)
+        inputs.push_back(std::string(len, static_cast<char>('a' + len % 26)));
+    inputs.push_back(std::string(20000, 'x'));
+    inputs.push_back("foo");
+    std::reverse(inputs.begin() + 100, inputs.end());
+
+    std::vector<std::string_view> views(inputs.begin(), inputs.end());
+    auto ids = c4::ID::IdentifyBatch(views);
+    REQUIRE(ids.size() == inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        REQUIRE(ids[i] == c4::ID::Identify(inputs[i]));
+    }
+}
+
+TEST_CASE("C4 ID: IdentifyBatch matches Go test vectors", "[c4][id][batch]") {
+    std::vector<std::string_view> views(std::begin(test_inputs), std::end(test_inputs));
+    auto ids = c4::ID::IdentifyBatch(views);
+    for (size_t i = 0; i < ids.size(); i++) {
+        REQUIRE(ids[i].String() == test_input_ids[i]);
+    }
+}
+
+TEST_CASE("Hasher: chunked updates match Identify", "[c4][id][hasher]") {
+    std::string data;
+    for (int i = 0; i < 5000; i++)
+        data += static_cast<char>(i * 31);
+
+    c4::Hasher h;
+    for (size_t pos = 0, step = 1; pos < data.size(); pos += step, step = step * 2 + 1) {
+        h.Update(std::string_view(data).substr(pos, step));
+    }
+    REQUIRE(h.Finalize() == c4::ID::Identify(data));
+}
+
+TEST_CASE("Hasher: Finalize resets for reuse", "[c4][id][hasher]") {
+    c4::Hasher h;
+    h.Update("foo");
+    REQUIRE(h.Finalize() == c4::ID::Identify("foo"));
+    REQUIRE(h.Finalize() == c4::ID::Identify("", 0));
+
+    h.Update("discarded");
+    h.Reset();
+    h.Update("alfa");
+    REQUIRE(h.Finalize().String() == test_input_ids[0]);
+}
+
 TEST_CASE("C4 ID: digest access", "[c4][id]") {
     auto id = c4::ID::Identify("test");
     const auto &digest = id.Digest();
@@ -237,6 +462,161 @@ TEST_CASE("C API: identify and string", "[c4][c-api]") {
     c4_id_free(id);
 }
 
+TEST_CASE("C API: identify_many matches identify", "[c4][c-api]") {
+    const char *inputs[] = {"alfa", "", "bravo", "charlie"};
+    const void *data[4];
+    size_t lens[4];
+    c4_id_t *out[4];
+    for (int i = 0; i < 4; i++) {
+        data[i] = inputs[i];
+        lens[i] = std::strlen(inputs[i]);
+        out[i] = c4_id_new();
+    }
+    REQUIRE(c4_identify_many(data, lens, 4, out) == C4_OK);
+
+    c4_id_t *single = c4_id_new();
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(c4_identify(inputs[i], lens[i], single) == C4_OK);
+        REQUIRE(c4_id_equal(out[i], single));
+        c4_id_free(out[i]);
+    }
+    c4_id_free(single);
+}
+
+TEST_CASE("C API: hasher", "[c4][c-api]") {
+    c4_hasher_t *h = c4_hasher_new();
+    REQUIRE(h != nullptr);
+    c4_id_t *id = c4_id_new();
+
+    REQUIRE(c4_hasher_update(h, "f", 1) == C4_OK);
+    REQUIRE(c4_hasher_update(h, "oo", 2) == C4_OK);
+    REQUIRE(c4_hasher_final(h, id) == C4_OK);
+
+    char buf[91];
+    REQUIRE(c4_id_string(id, buf, sizeof(buf)) == C4_OK);
+    REQUIRE(std::string(buf) ==
+        "c45xZeXwMSpqXjpDumcHMA6mhoAmGHkUo7r9WmN2UgSEQzj9KjgseaQdkEJ11fGb5S1WEENcV3q8RFWwEeVpC7Fjk2");
+
+    REQUIRE(c4_hasher_update(nullptr, "x", 1) == C4_ERR_INVALID_INPUT);
+    REQUIRE(c4_hasher_reset(h) == C4_OK);
+
+    c4_id_free(id);
+    c4_hasher_free(h);
+}
+
+TEST_CASE("C4 ID: IdentifyFile matches Identify for every I/O strategy", "[c4][id][file]") {
+    const c4::IOStrategy strategies[] = {
+        c4::IOStrategy::Auto, c4::IOStrategy::Stream, c4::IOStrategy::Mmap,
+        c4::IOStrategy::Pread, c4::IOStrategy::Direct,
+    };
+    // Empty, sub-block, exactly two 4 MiB read chunks, and a ragged
+    // multi-chunk size that exercises the double-buffered reader.
+    const size_t sizes[] = {0, 5000, 8u << 20, (9u << 20) + 123};
+
+    auto path = std::filesystem::temp_directory_path() / "c4_identify_file_test.bin";
+    for (size_t size : sizes) {
+        std::string data(size, '\0');
+        for (size_t i = 0; i < size; i++)
+            data[i] = static_cast<char>(i * 7 + (i >> 12));
+        {
+            std::ofstream f(path, std::ios::binary);
+            f.write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+        auto expected = c4::ID::Identify(data);
+        for (auto io : strategies) {
+            c4::IdentifyOptions opts;
+            opts.io = io;
+            REQUIRE(c4::ID::IdentifyFile(path, opts) == expected);
+        }
+        REQUIRE(c4::ID::IdentifyFile(path) == expected);
+    }
+    std::filesystem::remove(path);
+
+    REQUIRE_THROWS(c4::ID::IdentifyFile(path));
+}
+
+TEST_CASE("C4 ID: IdentifyFiles matches IdentifyFile in input order", "[c4][id][file]") {
+    auto root = std::filesystem::temp_directory_path() / "c4_identify_files_test";
+    std::filesystem::remove_all(root);
+    std::vector<std::filesystem::path> paths;
+    for (int d = 0; d < 3; d++) {
+        auto dir = root / ("dir" + std::to_string(d));
+        std::filesystem::create_directories(dir);
+        for (int f = 0; f < 40; f++) {
+            auto path = dir / ("file" + std::to_string(f) + ".bin");
+            std::ofstream(path, std::ios::binary) << std::string(static_cast<size_t>(f * 97), 'a' + d);
+            paths.push_back(path);
+        }
+    }
+    // Large file (double-buffered path) and a c4m file (canonicalized).
+    {
+        std::ofstream(root / "large.bin", std::ios::binary) << std::string((5u << 20) + 3, 'z');
+        std::ofstream(root / "listing.c4m", std::ios::binary)
+            << "-rw-r--r-- 2025-01-01T00:00:00Z 100  file.txt -\n";
+    }
+    paths.insert(paths.begin() + 50, root / "large.bin");
+    paths.push_back(root / "listing.c4m");
+    std::reverse(paths.begin() + 10, paths.begin() + 30);
+
+    for (unsigned threads : {1u, 4u}) {
+        c4::IdentifyOptions opts;
+        opts.threads = threads;
+        auto ids = c4::IdentifyFiles(paths, opts);
+        REQUIRE(ids.size() == paths.size());
+        for (size_t i = 0; i < paths.size(); i++) {
+            REQUIRE(ids[i] == c4::ID::IdentifyFile(paths[i]));
+        }
+    }
+
+    paths.push_back(root / "missing.bin");
+    REQUIRE_THROWS(c4::IdentifyFiles(paths));
+    std::filesystem::remove_all(root);
+}
+
+#ifndef _WIN32
+TEST_CASE("C API: identify_fd streams a multi-chunk file", "[c4][c-api][fd]") {
+    // Larger than the 1 MiB read chunk so several reads are hashed.
+    std::string data(3 * 1024 * 1024 + 17, '\0');
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<char>(i * 131 + (i >> 13));
+
+    auto path = std::filesystem::temp_directory_path() / "c4_identify_fd_test.bin";
+    {
+        std::ofstream f(path, std::ios::binary);
+        f.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    REQUIRE(fd >= 0);
+    c4_id_t *id = c4_id_new();
+    REQUIRE(c4_identify_fd(fd, id) == C4_OK);
+    close(fd);
+
+    auto expected = c4::ID::Identify(data);
+    REQUIRE(std::memcmp(c4_id_digest(id), expected.Digest().data(), 64) == 0);
+
+    // Reading starts at the current offset.
+    fd = open(path.c_str(), O_RDONLY);
+    REQUIRE(lseek(fd, 1000, SEEK_SET) == 1000);
+    REQUIRE(c4_identify_fd_hint(fd, data.size() - 1000, id) == C4_OK);
+    close(fd);
+    expected = c4::ID::Identify(std::string_view(data).substr(1000));
+    REQUIRE(std::memcmp(c4_id_digest(id), expected.Digest().data(), 64) == 0);
+
+    c4_id_free(id);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("C4 ID: IdentifyFd reads a pipe", "[c4][id][fd]") {
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    REQUIRE(write(fds[1], "foo", 3) == 3);
+    close(fds[1]);
+    REQUIRE(c4::ID::IdentifyFd(fds[0]) == c4::ID::Identify("foo"));
+    close(fds[0]);
+}
+#endif
+
 TEST_CASE("C API: parse round-trip", "[c4][c-api]") {
     c4_id_t *id = c4_id_new();
     const char *str =
@@ -250,6 +630,15 @@ TEST_CASE("C API: parse round-trip", "[c4][c-api]") {
     c4_id_free(id);
 }
 
+TEST_CASE("C API: parse rejects invalid IDs", "[c4][c-api]") {
+    c4_id_t *id = c4_id_new();
+    std::string overflow = "c4" + std::string(88, 'z');
+    REQUIRE(c4_id_parse("c4short", 7, id) == C4_ERR_INVALID_ID);
+    REQUIRE(c4_id_parse(overflow.data(), overflow.size(), id) == C4_ERR_INVALID_ID);
+    REQUIRE(c4_id_parse(nullptr, 90, id) == C4_ERR_INVALID_INPUT);
+    c4_id_free(id);
+}
+
 TEST_CASE("C API: from_digest round-trip", "[c4][c-api]") {
     c4_id_t *id = c4_id_new();
     REQUIRE(c4_identify("bravo", 5, id) == C4_OK);
@@ -339,3 +728,528 @@ TEST_CASE("Tree ID: two IDs equal to Sum", "[c4][tree]") {
     auto sum = a.Sum(b);
     REQUIRE(tree == sum);
 }
+
+TEST_CASE("Tree ID: matches a pairwise Sum reduction", "[c4][tree]") {
+    // Sizes straddle the SIMD lane widths and odd pass-through levels.
+    for (int n : {3, 5, 8, 9, 16, 17, 31, 100, 257}) {
+        c4::IDs ids;
+        std::vector<c4::ID> level;
+        for (int i = 0; i < n; i++) {
+            auto id = c4::ID::Identify("tree-" + std::to_string(i));
+            ids.Append(id);
+            level.push_back(id);
+        }
+        std::sort(level.begin(), level.end());
+        while (level.size() > 1) {
+            std::vector<c4::ID> next;
+            for (size_t i = 0; i + 1 < level.size(); i += 2)
+                next.push_back(level[i].Sum(level[i + 1]));
+            if (level.size() % 2)
+                next.push_back(level.back());
+            level = std::move(next);
+        }
+        REQUIRE(ids.TreeID() == level[0]);
+    }
+}
+
+TEST_CASE("Tree ID: ParallelTreeID matches TreeID", "[c4][tree]") {
+    for (int n : {1, 2, 100, 5000, 20001}) {
+        c4::IDs ids;
+        for (int i = 0; i < n; i++) {
+            ids.Append(c4::ID::Identify("parallel-tree-" + std::to_string(i)));
+            if (i % 7 == 0)  // duplicates must still be removed
+                ids.Append(c4::ID::Identify("parallel-tree-" + std::to_string(i / 2)));
+        }
+        auto expected = ids.TreeID();
+        for (unsigned threads : {0u, 1u, 3u, 8u})
+            REQUIRE(ids.ParallelTreeID(threads) == expected);
+    }
+}
+
+// =============================================================
+// TreeBuilder tests
+// =============================================================
+
+TEST_CASE("Tree ID: sorted and consumed sets match a copy", "[c4][tree]") {
+    c4::IDs ids;
+    for (int i = 0; i < 777; i++)
+        ids.Append(c4::ID::Identify("arena-" + std::to_string(i % 500)));
+    REQUIRE_FALSE(ids.SortedUnique());
+    REQUIRE(reinterpret_cast<uintptr_t>(&ids[0]) % 64 == 0);
+    auto expected = ids.TreeID();
+
+    auto sorted = ids;
+    sorted.SortUnique();
+    REQUIRE(sorted.SortedUnique());
+    REQUIRE(sorted.Size() == 500);
+    REQUIRE(std::is_sorted(sorted.begin(), sorted.end()));
+    REQUIRE(sorted.TreeID() == expected);
+    REQUIRE(sorted.ParallelTreeID(2) == expected);
+
+    // Appending in ascending order keeps the flag; anything else clears it.
+    c4::IDs ascending;
+    for (const auto &id : sorted)
+        ascending.Append(id);
+    REQUIRE(ascending.SortedUnique());
+    ascending.Append(sorted[0]);
+    REQUIRE_FALSE(ascending.SortedUnique());
+
+    REQUIRE(std::move(ascending).TreeID() == expected);
+    REQUIRE(ascending.Empty());
+    REQUIRE(c4::IDs(ids).TreeID() == expected);
+}
+
+TEST_CASE("TreeBuilder: matches TreeID for every size up to 1100", "[c4][tree]") {
+    std::vector<c4::ID> sorted;
+    for (int i = 0; i < 1100; i++)
+        sorted.push_back(c4::ID::Identify("builder-" + std::to_string(i)));
+    std::sort(sorted.begin(), sorted.end());
+
+    c4::TreeBuilder builder;
+    REQUIRE(builder.Finalize().IsNil());
+
+    c4::IDs ids;
+    for (size_t n = 1; n <= sorted.size(); n++) {
+        ids.Append(sorted[n - 1]);
+        // Spot-check around the leaf batch boundaries, every size below
+        if (n > 80 && n % 97 != 0 && (n < 500 || n > 530) && (n < 1010 || n > 1040))
+            continue;
+        for (size_t i = 0; i < n; i++)
+            builder.Add(sorted[i]);
+        REQUIRE(builder.Count() == n);
+        REQUIRE(builder.Finalize() == ids.TreeID());
+        REQUIRE(builder.Count() == 0);
+    }
+}
+
+TEST_CASE("TreeBuilder: skips repeats and rejects unsorted input", "[c4][tree]") {
+    auto a = c4::ID::Identify("alfa");
+    auto b = c4::ID::Identify("bravo");
+    const auto &lo = a < b ? a : b;
+    const auto &hi = a < b ? b : a;
+
+    c4::TreeBuilder builder;
+    builder.Add(lo);
+    builder.Add(lo);
+    builder.Add(hi);
+    REQUIRE(builder.Count() == 2);
+    REQUIRE_THROWS_AS(builder.Add(lo), std::invalid_argument);
+    REQUIRE(builder.Finalize() == lo.Sum(hi));
+}
+
+// =============================================================
+// IncrementalIDs tests
+// =============================================================
+
+TEST_CASE("IncrementalIDs: tracks TreeID through inserts and removals", "[c4][tree]") {
+    std::vector<c4::ID> pool;
+    for (int i = 0; i < 3000; i++)
+        pool.push_back(c4::ID::Identify("incremental-" + std::to_string(i)));
+
+    std::set<c4::ID> reference(pool.begin(), pool.begin() + 1000);
+    c4::IDs initial;
+    for (const auto &id : reference)
+        initial.Append(id);
+    c4::IncrementalIDs inc(initial);
+    REQUIRE(inc.TreeID() == initial.TreeID());
+
+    auto expected = [&] {
+        c4::IDs ids;
+        for (const auto &id : reference)
+            ids.Append(id);
+        return ids.TreeID();
+    };
+
+    uint32_t rng = 12345;
+    auto next = [&] {
+        rng = rng * 1103515245u + 12345u;
+        return (rng >> 8) % pool.size();
+    };
+    for (int round = 0; round < 40; round++) {
+        // Mix of fresh inserts, duplicate inserts, removals and no-op removals,
+        // including a clustered run in some rounds.
+        int changes = 1 + round % 9;
+        for (int c = 0; c < changes; c++) {
+            const auto &id = pool[next()];
+            if ((round + c) % 3 == 0) {
+                inc.Remove(id);
+                reference.erase(id);
+            } else {
+                inc.Insert(id);
+                reference.insert(id);
+            }
+        }
+        if (round % 5 == 0) {
+            size_t start = next();
+            for (size_t k = 0; k < 20; k++) {
+                inc.Insert(pool[(start + k) % pool.size()]);
+                reference.insert(pool[(start + k) % pool.size()]);
+            }
+        }
+        REQUIRE(inc.Size() == reference.size());
+        REQUIRE(inc.TreeID() == expected());
+    }
+
+    // Last queued change for an ID wins.
+    auto extra = c4::ID::Identify("incremental-extra");
+    inc.Insert(extra);
+    inc.Remove(extra);
+    REQUIRE_FALSE(inc.Contains(extra));
+    REQUIRE(inc.TreeID() == expected());
+}
+
+TEST_CASE("IncrementalIDs: grows from and shrinks to empty", "[c4][tree]") {
+    c4::IncrementalIDs inc;
+    REQUIRE(inc.TreeID().IsNil());
+
+    c4::IDs ids;
+    for (int i = 0; i < 70; i++) {
+        auto id = c4::ID::Identify("grow-" + std::to_string(i));
+        inc.Insert(id);
+        ids.Append(id);
+        REQUIRE(inc.TreeID() == ids.TreeID());
+    }
+    for (const auto &id : ids)
+        inc.Remove(id);
+    REQUIRE(inc.Size() == 0);
+    REQUIRE(inc.TreeID().IsNil());
+}
+
+// =============================================================
+// Inclusion proof tests
+// =============================================================
+
+TEST_CASE("Inclusion proof: every member verifies against TreeID", "[c4][tree]") {
+    for (int n : {1, 2, 3, 7, 8, 13, 64, 101}) {
+        c4::IDs ids;
+        for (int i = 0; i < n; i++)
+            ids.Append(c4::ID::Identify("proof-" + std::to_string(i)));
+        ids.Append(ids[0]);  // duplicates do not count as leaves
+        auto tree = ids.TreeID();
+        c4::IncrementalIDs inc(ids);
+
+        for (const auto &id : ids) {
+            auto proof = ids.Proof(id);
+            REQUIRE(proof.count == static_cast<uint64_t>(n));
+            REQUIRE(c4::VerifyInclusion(id, proof, tree));
+
+            auto cached = inc.Proof(id);
+            REQUIRE(cached.index == proof.index);
+            REQUIRE(cached.siblings == proof.siblings);
+        }
+
+        // A sorted set reads its leaves in place; the proofs must not change.
+        c4::IDs sorted = ids;
+        sorted.SortUnique();
+        for (const auto &id : ids) {
+            auto in_place = sorted.Proof(id);
+            auto copied = ids.Proof(id);
+            REQUIRE(in_place.index == copied.index);
+            REQUIRE(in_place.siblings == copied.siblings);
+        }
+    }
+}
+
+TEST_CASE("Inclusion proof: rejects wrong IDs, trees and tampered proofs", "[c4][tree]") {
+    c4::IDs ids;
+    for (int i = 0; i < 11; i++)
+        ids.Append(c4::ID::Identify("proof-" + std::to_string(i)));
+    auto tree = ids.TreeID();
+    auto outsider = c4::ID::Identify("not in the set");
+
+    auto proof = ids.Proof(ids[4]);
+    REQUIRE_FALSE(c4::VerifyInclusion(outsider, proof, tree));
+    REQUIRE_FALSE(c4::VerifyInclusion(ids[4], proof, outsider));
+
+    auto tampered = proof;
+    tampered.siblings[1] = outsider;
+    REQUIRE_FALSE(c4::VerifyInclusion(ids[4], tampered, tree));
+
+    auto truncated = proof;
+    truncated.siblings.pop_back();
+    REQUIRE_FALSE(c4::VerifyInclusion(ids[4], truncated, tree));
+
+    auto out_of_range = proof;
+    out_of_range.index = out_of_range.count;
+    REQUIRE_FALSE(c4::VerifyInclusion(ids[4], out_of_range, tree));
+
+    REQUIRE_THROWS_AS(ids.Proof(outsider), std::invalid_argument);
+}
+
+// =============================================================
+// IDSet / IDMap
+// =============================================================
+
+TEST_CASE("IDSet: matches std::set through inserts and removals", "[c4][idset]") {
+    // Half of the IDs share their first 8 bytes (same slot and tag), so
+    // lookups must fall back to the full digest and removals shift long
+    // clusters.
+    std::vector<c4::ID> pool;
+    for (int i = 0; i < 3000; i++) {
+        auto id = c4::ID::Identify("idset-" + std::to_string(i));
+        if (i % 2) {
+            auto digest = id.Digest();
+            std::memset(digest.data(), 0x5A, 8);
+            id = c4::ID(digest);
+        }
+        pool.push_back(id);
+    }
+
+    c4::IDSet set;
+    std::set<c4::ID> ref;
+    uint64_t x = 12345;
+    for (int step = 0; step < 20000; step++) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto &id = pool[(x >> 33) % pool.size()];
+        if ((x >> 20) % 3 == 0) {
+            REQUIRE(set.Remove(id) == (ref.erase(id) == 1));
+        } else {
+            REQUIRE(set.Insert(id) == ref.insert(id).second);
+        }
+        REQUIRE(set.Size() == ref.size());
+    }
+
+    for (const auto &id : pool)
+        REQUIRE(set.Contains(id) == (ref.count(id) == 1));
+    std::set<c4::ID> iterated(set.begin(), set.end());
+    REQUIRE(iterated == ref);
+
+    set.Clear();
+    REQUIRE(set.Empty());
+    REQUIRE_FALSE(set.Contains(pool[0]));
+}
+
+TEST_CASE("IDMap: values follow their keys", "[c4][idset]") {
+    c4::IDMap<std::string> map;
+    map.Reserve(100);
+    for (int i = 0; i < 100; i++)
+        map[c4::ID::Identify(std::to_string(i))] = std::to_string(i);
+
+    auto [value, inserted] = map.Insert(c4::ID::Identify("7"), "other");
+    REQUIRE_FALSE(inserted);
+    REQUIRE(*value == "7");
+
+    for (int i = 0; i < 100; i += 3)
+        REQUIRE(map.Remove(c4::ID::Identify(std::to_string(i))));
+    REQUIRE_FALSE(map.Remove(c4::ID::Identify("0")));
+    REQUIRE(map.Size() == 66);
+
+    for (int i = 0; i < 100; i++) {
+        const auto *found = map.Find(c4::ID::Identify(std::to_string(i)));
+        if (i % 3 == 0) {
+            REQUIRE(found == nullptr);
+        } else {
+            REQUIRE(found != nullptr);
+            REQUIRE(*found == std::to_string(i));
+        }
+    }
+
+    size_t i = 0;
+    for (const auto &id : map.Keys())
+        REQUIRE(id == c4::ID::Identify(map.Values()[i++]));
+}
+
+TEST_CASE("IDMap: a throwing value constructor leaves the map unchanged", "[c4][idset]") {
+    struct Fragile {
+        Fragile() { throw std::runtime_error("no default"); }
+        explicit Fragile(int v) : value(v) {}
+        Fragile(Fragile &&other) : value(other.value) {
+            if (value < 0)
+                throw std::runtime_error("bad move");
+        }
+        Fragile &operator=(Fragile &&) = default;
+        int value;
+    };
+
+    c4::IDMap<Fragile> map;
+    auto kept = c4::ID::Identify("kept");
+    auto lost = c4::ID::Identify("lost");
+    REQUIRE(map.Insert(kept, Fragile(1)).second);
+
+    REQUIRE_THROWS_AS(map[lost], std::runtime_error);
+    REQUIRE_THROWS_AS(map.Insert(lost, Fragile(-1)), std::runtime_error);
+    REQUIRE(map.Size() == 1);
+    REQUIRE_FALSE(map.Contains(lost));
+    REQUIRE(map.Find(kept)->value == 1);
+
+    REQUIRE(map.Insert(lost, Fragile(2)).second);
+    REQUIRE(map.Find(lost)->value == 2);
+}
+
+// =============================================================
+// IDList
+// =============================================================
+
+TEST_CASE("IDList: round-trips a set with and without fanout", "[c4][idlist]") {
+    auto path = std::filesystem::temp_directory_path() / "c4_idlist_test.bin";
+    c4::IDs ids;
+    for (int i = 0; i < 1500; i++)
+        ids.Append(c4::ID::Identify("idlist-" + std::to_string(i % 1000)));
+    auto sorted = ids;
+    sorted.SortUnique();
+
+    for (bool fanout : {true, false}) {
+        c4::IDList::Write(path, ids, fanout);
+        auto list = c4::IDList::Open(path);
+        REQUIRE(list.Size() == 1000);
+        for (size_t i = 0; i < sorted.Size(); i++) {
+            REQUIRE(list[i] == sorted[i]);
+            REQUIRE(list.Contains(sorted[i]));
+        }
+        REQUIRE_FALSE(list.Contains(c4::ID::Identify("idlist-1000")));
+        REQUIRE_FALSE(list.Contains(c4::ID()));
+        REQUIRE(list.TreeID() == ids.TreeID());
+
+        auto moved = std::move(list);
+        REQUIRE(moved.Size() == 1000);
+        REQUIRE(list.Empty());
+    }
+
+    c4::IDList::Write(path, c4::IDs());
+    auto empty = c4::IDList::Open(path);
+    REQUIRE(empty.Empty());
+    REQUIRE(empty.TreeID().IsNil());
+    REQUIRE_FALSE(empty.Contains(ids[0]));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("IDList: rejects malformed files", "[c4][idlist]") {
+    auto path = std::filesystem::temp_directory_path() / "c4_idlist_bad.bin";
+    c4::IDs ids;
+    for (int i = 0; i < 10; i++)
+        ids.Append(c4::ID::Identify(std::to_string(i)));
+    c4::IDList::Write(path, ids);
+    auto size = std::filesystem::file_size(path);
+
+    std::filesystem::resize_file(path, size - 1);
+    REQUIRE_THROWS_AS(c4::IDList::Open(path), std::runtime_error);
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "not an ID list at all, just some text that is long enough for a header";
+    }
+    REQUIRE_THROWS_AS(c4::IDList::Open(path), std::runtime_error);
+
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS(c4::IDList::Open(path), std::runtime_error);
+}
+
+// =============================================================
+// IDFilter
+// =============================================================
+
+TEST_CASE("IDFilter: no false negatives and a low false-positive rate", "[c4][idfilter]") {
+    constexpr int N = 100000;
+    c4::IDs ids;
+    for (int i = 0; i < N; i++)
+        ids.Append(c4::ID::Identify("member-" + std::to_string(i)));
+
+    for (unsigned bits : {4u, c4::IDFilter::DefaultBitsPerID, 20u}) {
+        auto filter = c4::IDFilter::Build(ids, bits);
+        for (const auto &id : ids)
+            REQUIRE(filter.MayContain(id));
+
+        std::vector<c4::ID> outsiders;
+        for (int i = 0; i < N; i++)
+            outsiders.push_back(c4::ID::Identify("outsider-" + std::to_string(i)));
+        std::unique_ptr<bool[]> found(new bool[N]);
+        filter.MayContainMany(outsiders.data(), N, found.get());
+
+        int false_positives = 0;
+        for (int i = 0; i < N; i++) {
+            REQUIRE(found[i] == filter.MayContain(outsiders[i]));
+            false_positives += found[i];
+        }
+        double rate = static_cast<double>(false_positives) / N;
+        INFO("bits per ID " << bits << ": false-positive rate " << rate);
+        REQUIRE(rate < (bits == 4 ? 0.25 : bits == 20 ? 0.001 : 0.01));
+    }
+
+    REQUIRE_FALSE(c4::IDFilter().MayContain(ids[0]));
+    REQUIRE_THROWS_AS(c4::IDFilter(10, 0), std::invalid_argument);
+}
+
+TEST_CASE("IDFilter: file round-trip", "[c4][idfilter]") {
+    auto path = std::filesystem::temp_directory_path() / "c4_idfilter_test.bin";
+    c4::IDs ids;
+    for (int i = 0; i < 1000; i++)
+        ids.Append(c4::ID::Identify(std::to_string(i)));
+    auto filter = c4::IDFilter::Build(ids);
+    filter.Write(path);
+
+    auto loaded = c4::IDFilter::Read(path);
+    REQUIRE(loaded.Bytes() == filter.Bytes());
+    REQUIRE(loaded.HashCount() == filter.HashCount());
+    for (int i = 0; i < 2000; i++) {
+        auto id = c4::ID::Identify(std::to_string(i));
+        REQUIRE(loaded.MayContain(id) == filter.MayContain(id));
+    }
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    REQUIRE_THROWS_AS(c4::IDFilter::Read(path), std::runtime_error);
+    std::filesystem::remove(path);
+
+    REQUIRE_THROWS_AS(c4::IDFilter().Write(path), std::logic_error);
+    REQUIRE_FALSE(std::filesystem::exists(path));
+}
+
+// =============================================================
+// PrefixIndex
+// =============================================================
+
+TEST_CASE("PrefixIndex: matches a linear scan of the encoded IDs", "[c4][prefix]") {
+    c4::IDs ids;
+    for (int i = 0; i < 2000; i++)
+        ids.Append(c4::ID::Identify("prefix-" + std::to_string(i % 1500)));
+    std::vector<std::string> strings;
+    for (const auto &id : ids)
+        strings.push_back(id.String());
+
+    c4::PrefixIndex index(ids);
+    REQUIRE(index.Size() == 1500);
+
+    auto scan = [&](const std::string &prefix) {
+        std::set<std::string> found;
+        for (const auto &s : strings)
+            if (s.compare(0, prefix.size(), prefix) == 0)
+                found.insert(s);
+        return found;
+    };
+
+    for (size_t i = 0; i < strings.size(); i += 37) {
+        for (size_t len : {2u, 3u, 4u, 5u, 6u, 8u, 90u}) {
+            auto prefix = strings[i].substr(0, len);
+            auto expected = scan(prefix);
+            auto result = index.Resolve(prefix);
+            REQUIRE(result.count == expected.size());
+            REQUIRE(result.id.String() == *expected.begin());
+            REQUIRE(result.match == (expected.size() == 1 ? c4::PrefixMatch::Unique
+                                                           : c4::PrefixMatch::Ambiguous));
+        }
+    }
+}
+
+TEST_CASE("PrefixIndex: misses and invalid prefixes", "[c4][prefix]") {
+    c4::IDs ids;
+    ids.Append(c4::ID::Identify("only"));
+    c4::PrefixIndex index(std::move(ids));
+
+    auto id = c4::ID::Identify("only").String();
+    auto other = id.substr(0, 6) == "c41111" ? std::string("c4zzzz") : std::string("c41111");
+    REQUIRE(index.Resolve(other).match == c4::PrefixMatch::None);
+    REQUIRE(index.Resolve("c4").match == c4::PrefixMatch::Unique);
+    REQUIRE(index.Resolve(id).id == c4::ID::Identify("only"));
+
+    // Above the largest possible ID: no match, not an error.
+    REQUIRE(index.Resolve("c47").match == c4::PrefixMatch::None);
+    REQUIRE(index.Resolve("c4z").match == c4::PrefixMatch::None);
+
+    REQUIRE(index.Resolve("").match == c4::PrefixMatch::Invalid);
+    REQUIRE(index.Resolve("c").match == c4::PrefixMatch::Invalid);
+    REQUIRE(index.Resolve("x4abc").match == c4::PrefixMatch::Invalid);
+    REQUIRE(index.Resolve("c4ab0").match == c4::PrefixMatch::Invalid);
+    REQUIRE(index.Resolve(id + "1").match == c4::PrefixMatch::Invalid);
+
+    REQUIRE(c4::PrefixIndex().Resolve("c4abc").match == c4::PrefixMatch::None);
+}
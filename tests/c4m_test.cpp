@@ -8,8 +8,12 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <ctime>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 // =============================================================
 // Mode formatting / parsing
@@ -109,6 +113,41 @@ TEST_CASE("C4M: timestamp round-trip", "[c4m][timestamp]") {
     REQUIRE(parsed == original);
 }
 
+TEST_CASE("C4M: timestamp calendar edge cases", "[c4m][timestamp]") {
+    REQUIRE(c4m::ParseTimestamp("1969-12-31T23:59:59Z") == -1);
+    REQUIRE(c4m::ParseTimestamp("1900-03-01T00:00:00Z") == -2203891200);
+    REQUIRE(c4m::ParseTimestamp("2000-02-29T12:00:00Z") == 951825600);
+    REQUIRE(c4m::ParseTimestamp("9999-12-31T23:59:59Z") == 253402300799);
+    REQUIRE(c4m::FormatTimestamp(-1) == "1969-12-31T23:59:59Z");
+    REQUIRE(c4m::FormatTimestamp(951825600) == "2000-02-29T12:00:00Z");
+    REQUIRE(c4m::FormatTimestamp(253402300799) == "9999-12-31T23:59:59Z");
+
+    // Out-of-range fields roll over as timegm normalizes them.
+    REQUIRE(c4m::ParseTimestamp("2024-01-31T24:00:00Z") == 1706745600);
+    REQUIRE(c4m::ParseTimestamp("2024-01-32T00:00:00Z") == 1706745600);
+    REQUIRE(c4m::ParseTimestamp("2024-01-31T23:00:00-01:00") == 1706745600);
+
+    REQUIRE_THROWS_AS(c4m::ParseTimestamp("2024-01-31"), std::invalid_argument);
+    REQUIRE_THROWS_AS(c4m::ParseTimestamp("2024-01-31Tab:00:00Z"), std::invalid_argument);
+}
+
+TEST_CASE("C4M: timestamp round-trip across 1900 to 2100", "[c4m][timestamp]") {
+    // Steps of a little over 37 days visit every month, day and time of day
+    // and alternate between dates to exercise the last-date caches.
+    for (int64_t ts = -2208988800; ts < 4102444800; ts += 86400 * 37 + 3607) {
+        std::string s = c4m::FormatTimestamp(ts);
+        REQUIRE(c4m::ParseTimestamp(s) == ts);
+#ifndef _WIN32
+        time_t t = static_cast<time_t>(ts);
+        struct tm utc{};
+        gmtime_r(&t, &utc);
+        char want[32];
+        REQUIRE(std::strftime(want, sizeof(want), "%Y-%m-%dT%H:%M:%SZ", &utc) == 20);
+        REQUIRE(s == want);
+#endif
+    }
+}
+
 // =============================================================
 // Entry formatting -- INTEROP: canonical vs display
 // =============================================================
@@ -579,6 +618,28 @@ TEST_CASE("C4M: parse with comma-formatted size", "[c4m][parser]") {
     REQUIRE(m.Entries()[0].size == 1234567);
 }
 
+TEST_CASE("C4M: parse rejects size out of range", "[c4m][parser]") {
+    std::string input =
+        "-rw-r--r-- 2024-01-01T00:00:00Z 9223372036854775808 huge.bin -\n";
+    REQUIRE_THROWS_AS(c4m::Manifest::Parse(input), std::runtime_error);
+}
+
+TEST_CASE("C4M: parse sequence notation only when unescaped", "[c4m][parser]") {
+    std::string input =
+        "-rw-r--r-- 2024-01-01T00:00:00Z 100 frame.[0001-0100].exr -\n"
+        "-rw-r--r-- 2024-01-01T00:00:00Z 100 take\\[0001-0100\\].exr -\n"
+        "-rw-r--r-- 2024-01-01T00:00:00Z 100 a[x][1,3:5].exr -\n"
+        "-rw-r--r-- 2024-01-01T00:00:00Z 100 b[].exr -\n";
+    auto m = c4m::Manifest::Parse(input);
+    REQUIRE(m.EntryCount() == 4);
+    REQUIRE(m.Entries()[0].is_sequence);
+    REQUIRE(m.Entries()[0].pattern == "frame.[0001-0100].exr");
+    REQUIRE_FALSE(m.Entries()[1].is_sequence);
+    REQUIRE(m.Entries()[1].name == "take[0001-0100].exr");
+    REQUIRE(m.Entries()[2].is_sequence);
+    REQUIRE_FALSE(m.Entries()[3].is_sequence);
+}
+
 // =============================================================
 // Parser: reject CR (INTEROP FIX 5)
 // =============================================================
@@ -587,6 +648,162 @@ TEST_CASE("C4M: parser rejects CR in line", "[c4m][parser]") {
     std::string input =
         "-rw-r--r-- 2024-01-01T00:00:00Z 100 file.txt -\r\n";
     REQUIRE_THROWS(c4m::Manifest::Parse(input));
+
+    // Also on a last line without a newline, and from a stream.
+    REQUIRE_THROWS(c4m::Manifest::Parse(input.substr(0, input.size() - 1)));
+    std::istringstream in(input);
+    REQUIRE_THROWS(c4m::Manifest::Parse(in));
+}
+
+TEST_CASE("C4M: buffer, stream and file parsing agree", "[c4m][parser]") {
+    std::string input =
+        "-rw-r--r-- 2024-01-01T00:00:00Z 100 a.txt " + c4::ID::Identify("a").String() + "\n"
+        "\n"
+        "drwxr-xr-x 2024-01-01T00:00:00Z 4096 src/ -\n"
+        "  -rw-r--r-- 2024-01-01T00:00:00Z 5 main.go " + c4::ID::Identify("main").String() + "\n"
+        "  -rw-r--r-- 2024-01-01T00:00:00Z 7 util.go -";  // no trailing newline
+
+    auto from_buffer = c4m::Manifest::Parse(std::string_view(input));
+    std::istringstream in(input);
+    auto from_stream = c4m::Manifest::Parse(in);
+
+    auto path = std::filesystem::temp_directory_path() / "c4m_parse_file_test.c4m";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << input;
+    }
+    auto from_file = c4m::Manifest::ParseFile(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(from_buffer.EntryCount() == 4);
+    REQUIRE(from_buffer.Entries()[3].name == "util.go");
+    REQUIRE(from_buffer.Entries()[2].id == c4::ID::Identify("main"));
+    REQUIRE(from_stream.Encode() == from_buffer.Encode());
+    REQUIRE(from_file.Encode() == from_buffer.Encode());
+
+    REQUIRE_THROWS(c4m::Manifest::ParseFile(path));
+}
+
+TEST_CASE("C4M: parallel parse matches single-threaded parse", "[c4m][parser]") {
+    // About 4 MiB, so the buffer is split into chunks: an external base
+    // reference, indented entries, blank lines and a patch boundary.
+    std::string input = c4::ID::Identify("base").String() + "\n";
+    for (int d = 0; d < 1000; d++) {
+        if (d == 500)
+            input += c4::ID::Identify("checkpoint").String() + "\n";
+        input += "drwxr-xr-x 2024-01-01T00:00:00Z 4096 dir" + std::to_string(d) + "/ -\n";
+        for (int f = 0; f < 30; f++) {
+            auto name = "d" + std::to_string(d) + "f" + std::to_string(f);
+            input += "  -rw-r--r-- 2024-01-01T00:00:00Z 1,000 " + name + ".txt " +
+                     c4::ID::Identify(name).String() + "\n";
+        }
+        if (d % 100 == 0)
+            input += "\n";
+    }
+
+    auto serial = c4m::Manifest::Parse(std::string_view(input));
+    auto parallel = c4m::Manifest::Parse(std::string_view(input), 4);
+    REQUIRE(serial.EntryCount() == 31000);
+    REQUIRE(parallel.Base() == serial.Base());
+    REQUIRE(parallel.Encode() == serial.Encode());
+
+    // Errors carry the same message and line number, and the earliest one
+    // wins even when a later chunk fails too.
+    auto error_of = [](const std::string &text, unsigned threads) {
+        try {
+            c4m::Manifest::Parse(std::string_view(text), threads);
+        } catch (const std::exception &e) {
+            return std::string(e.what());
+        }
+        return std::string("no error");
+    };
+    std::string bad = input;
+    bad.replace(bad.find("d900f7.txt"), 10, "d900f7\r.tx");
+    REQUIRE(error_of(bad, 4) == error_of(bad, 1));
+    REQUIRE(error_of(bad, 4).find("CR (0x0D)") != std::string::npos);
+    bad.replace(bad.find("2024-01-01T00:00:00Z 1,000 d300f3."), 20, "yesterday-after-noon");
+    REQUIRE(error_of(bad, 4) == error_of(bad, 1));
+    REQUIRE(error_of(bad, 4).find("cannot parse timestamp") != std::string::npos);
+}
+
+TEST_CASE("C4M: ManifestReader yields the entries and paths of Parse", "[c4m][parser][reader]") {
+    // Includes an entry whose parent directory was closed by a shallower
+    // entry, which Manifest gives no parent.
+    std::string input =
+        c4::ID::Identify("base").String() + "\n"
+        "-rw-r--r-- 2024-01-01T00:00:00Z 100 a.txt " + c4::ID::Identify("a").String() + "\n"
+        "drwxr-xr-x 2024-01-01T00:00:00Z 4096 src/ -\n"
+        "  -rw-r--r-- 2024-01-01T00:00:00Z 5 main.go -\n"
+        "  drwxr-xr-x 2024-01-01T00:00:00Z 0 include/ -\n"
+        "    -rw-r--r-- 2024-01-01T00:00:00Z 7 my\\ header.h -\n"
+        "\n"
+        "  lrwxrwxrwx 2024-01-01T00:00:00Z 0 link -> main.go -\n"
+        "drwxr-xr-x 2024-01-01T00:00:00Z 0 docs/ -\n"
+        "    -rw-r--r-- 2024-01-01T00:00:00Z 9 orphan.txt -\n";
+    auto m = c4m::Manifest::Parse(input);
+
+    auto check = [&](c4m::ManifestReader &reader) {
+        c4m::Entry e;
+        size_t i = 0;
+        while (reader.Next(e)) {
+            REQUIRE(i < m.EntryCount());
+            const auto &want = m.Entries()[i++];
+            REQUIRE(e.Canonical() == want.Canonical());
+            REQUIRE(e.depth == want.depth);
+            REQUIRE(reader.Path() == m.EntryPath(&want));
+        }
+        REQUIRE(i == m.EntryCount());
+        REQUIRE(reader.Base() == m.Base());
+    };
+
+    c4m::ManifestReader from_buffer{std::string_view(input)};
+    check(from_buffer);
+    std::istringstream in(input);
+    c4m::ManifestReader from_stream(in);
+    check(from_stream);
+
+    auto path = std::filesystem::temp_directory_path() / "c4m_reader_test.c4m";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << input;
+    }
+    c4m::ManifestReader from_file(path);
+    check(from_file);
+    std::filesystem::remove(path);
+    REQUIRE_THROWS(c4m::ManifestReader(path));
+
+    // ForEach, and the line number of each entry.
+    c4m::ManifestReader reader{std::string_view(input)};
+    std::vector<std::string> paths;
+    reader.ForEach([&](const c4m::Entry &, const std::string &p) { paths.push_back(p); });
+    REQUIRE(paths.size() == 8);
+    REQUIRE(paths[4] == "src/include/my header.h");
+    REQUIRE(paths[7] == "orphan.txt");
+    REQUIRE(reader.LineNumber() == 10);
+}
+
+TEST_CASE("C4M: ManifestReader reports errors like Parse", "[c4m][parser][reader]") {
+    std::string input =
+        "-rw-r--r-- 2024-01-01T00:00:00Z 100 a.txt -\n"
+        "-rw-r--r-- 2024-01-01T00:00:00Z bad b.txt -\n";
+    c4m::ManifestReader reader{std::string_view(input)};
+    c4m::Entry e;
+    REQUIRE(reader.Next(e));
+    REQUIRE(e.name == "a.txt");
+
+    std::string parse_error, reader_error;
+    try {
+        c4m::Manifest::Parse(input);
+    } catch (const std::exception &ex) {
+        parse_error = ex.what();
+    }
+    try {
+        reader.Next(e);
+    } catch (const std::exception &ex) {
+        reader_error = ex.what();
+    }
+    REQUIRE_FALSE(reader_error.empty());
+    REQUIRE(reader_error == parse_error);
 }
 
 // =============================================================
@@ -910,6 +1127,22 @@ TEST_CASE("C4M: manifest GetEntry", "[c4m][manifest]") {
     REQUIRE(m.GetEntry("nonexistent") == nullptr);
 }
 
+TEST_CASE("C4M: manifest EntryIDs skips nil IDs", "[c4m][manifest]") {
+    c4m::Manifest m;
+    for (const char *name : {"a.txt", "b.txt", "c.txt"}) {
+        c4m::Entry e;
+        e.name = name;
+        if (name[0] != 'b')
+            e.id = c4::ID::Identify(name);
+        m.AddEntry(e);
+    }
+
+    auto ids = m.EntryIDs();
+    REQUIRE(ids.Size() == 2);
+    REQUIRE(ids[0] == c4::ID::Identify("a.txt"));
+    REQUIRE(ids[1] == c4::ID::Identify("c.txt"));
+}
+
 TEST_CASE("C4M: manifest RootID is deterministic", "[c4m][manifest]") {
     c4m::Manifest m;
     c4m::Entry e;